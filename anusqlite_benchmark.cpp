@@ -11,7 +11,30 @@
 #include <sstream>
 #include <thread>
 #include <mutex>
+#include <new>
 #include <atomic>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// SIMD intrinsics for the harness-side aggregation kernel
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 // AnuDB includes
 #include "Database.h"
@@ -38,6 +61,947 @@ const int NUM_THREADS = 4;                // Number of concurrent threads for pa
 const std::string DB_PATH_ANUDB = "./benchmark_anudb";
 const std::string DB_PATH_SQLITE = "./benchmark_sqlite.db";
 const std::string COLLECTION_NAME = "products";
+const int NUM_INDEX_BUILD_DOCUMENTS = 1000000;  // Documents loaded before timing index builds
+
+// Secondary indexes created by setup(), in creation order
+const std::vector<std::string> INDEX_FIELDS = {"price", "stock", "category", "rating", "available"};
+
+// Product categories produced by generateRandomProduct()
+const std::vector<std::string> CATEGORIES = {"Electronics", "Books", "Food", "Clothing"};
+
+// Top-K and pagination settings
+const std::vector<int> TOPK_SIZES = {10, 100, 1000};
+const std::vector<int> PAGE_DEPTHS = {1, 10, 50, 100};  // 1-based page numbers that are timed
+const int PAGE_SIZE = 20;
+const int TOPK_REPEATS = 20;              // Timed repetitions of each top-K / offset query
+const int KEYSET_WALKS = 3;               // Times the keyset walk is repeated from page 1
+const int AGGREGATION_REPEATS = 10;       // Timed repetitions of the grouped aggregation
+
+// Nested and sparse fields queried by the nested phase. Each is present only in
+// products of one category (25% of documents) and is matched against value.
+struct NestedField {
+    std::string path;
+    std::string category;
+    std::string value;
+};
+const std::vector<NestedField> NESTED_FIELDS = {
+    {"specs.ram", "Electronics", "8GB"},
+    {"specs.storage", "Electronics", "512GB"},
+    {"author", "Books", "Author 7"},
+    {"color", "Clothing", "Red"}
+};
+const int NESTED_REPEATS = 50;            // Timed repetitions of each nested-field query
+
+// Partial update settings. Each operator is applied in-engine and by client-side
+// read-modify-write to PARTIAL_UPDATE_OPS random products of each size class.
+const std::vector<std::string> PARTIAL_UPDATE_OPERATORS = {"$set", "$inc", "$push", "patch"};  // patch sets two fields
+const std::vector<std::string> PARTIAL_UPDATE_SIZES = {"default", "small", "medium", "large"};
+const int PARTIAL_UPDATE_DOCUMENTS = NUM_DOCUMENTS / 20;
+const int PARTIAL_UPDATE_OPS = NUM_QUERIES;
+
+// Delete-heavy settings. The oldest fraction of a TOMBSTONE_DOCUMENTS collection is
+// deleted, as rolling retention would, then reads are timed before and after compaction.
+const std::vector<int> DELETE_FRACTIONS = {25, 50, 90};  // Percent of documents deleted
+const int TOMBSTONE_DOCUMENTS = NUM_DOCUMENTS * 5;
+const int TOMBSTONE_REPEATS = 5;          // Timed repetitions of each range query and scan
+
+// Time-series settings. Readings from TS_SENSORS sensors are appended for --ts-duration
+// seconds while a query thread polls the recent window and an expiry thread deletes
+// readings older than the retention period.
+const int TS_SENSORS = 16;
+const int TS_QUERY_INTERVAL_MS = 100;     // Pause between time-window queries
+const int TS_EXPIRY_INTERVAL_MS = 1000;   // Pause between expiry passes
+
+// Soak settings. A mixed workload runs for --soak-duration seconds over a sliding
+// window of products: inserts append at the head and deletes trim the oldest.
+enum SoakOp { SOAK_READ, SOAK_INSERT, SOAK_UPDATE, SOAK_DELETE, SOAK_QUERY };
+const std::vector<int> SOAK_MIX_WEIGHTS = {50, 20, 15, 10, 5};  // Percent per SoakOp
+const std::string SOAK_TIMELINE_PREFIX = "./soak_timeline_";
+
+// Read-while-write settings. Reader threads time point lookups and price range queries
+// for RW_SECONDS at each write rate while writer threads insert and update at that rate.
+const int RW_SECONDS = 5;
+const int RW_RANGE_PERCENT = 20;          // Share of reads that are range queries
+const int RW_WRITE_POOL = 1000;           // Pre-generated products the writers cycle through
+
+// SQLite WAL checkpoint strategies selectable with --sqlite-checkpoint
+//   default          SQLite's own autocheckpoint at 1000 WAL pages
+//   auto-N           autocheckpoint at N pages
+//   passive, restart, truncate  autocheckpoint off, a background thread runs that
+//                    sqlite3_wal_checkpoint_v2 mode every CHECKPOINT_INTERVAL_MS
+//   idle             autocheckpoint off, a TRUNCATE checkpoint once no commit has
+//                    landed for CHECKPOINT_IDLE_MS
+const std::vector<std::string> SQLITE_CHECKPOINTS = {"default", "passive", "restart", "truncate", "idle"};
+const int CHECKPOINT_INTERVAL_MS = 200;
+const int CHECKPOINT_IDLE_MS = 50;
+const int CHECKPOINT_WRITES = NUM_DOCUMENTS * 2;  // Single-document writes timed by the checkpoint phase
+const int WAL_SAMPLE_EVERY = 100;         // Writes between WAL size samples
+
+// Bytes of each SQLite database file mapped with --mmap=on
+const int64_t MMAP_SIZE_BYTES = 1LL << 30;
+
+// Storage devices emulated by --storage-profile in the SQLite VFS: each call costs a fixed
+// latency plus its transfer time at the device bandwidth, and calls are served one at a time
+struct StorageProfile {
+    std::string name;
+    double readLatencyUs;
+    double writeLatencyUs;
+    double syncLatencyUs;
+    double readMBps;                      // 0 for no bandwidth limit
+    double writeMBps;
+};
+const std::vector<StorageProfile> STORAGE_PROFILES = {
+    {"none", 0, 0, 0, 0, 0},
+    {"sd", 600, 2000, 15000, 80, 20},     // Class 10 / A1 microSD card
+    {"emmc", 150, 400, 3000, 250, 100},   // eMMC 5.1 module
+    {"usb", 400, 1500, 20000, 30, 10}     // USB 2.0 flash drive
+};
+
+// Cold-start phase: store sizes reopened after eviction from the page cache, and the
+// point reads and queries timed on each before and after the cache is warm
+const std::vector<int> COLD_START_SIZES = {NUM_DOCUMENTS / 10, NUM_DOCUMENTS, NUM_DOCUMENTS * 5};
+const int COLD_START_OPS = 10;
+
+// Crash phase: writer kills per durability setting, the window each kill lands in after
+// the writer starts, and a cap on the writes the writer attempts
+const int CRASH_TRIALS = 3;
+const int CRASH_MIN_MS = 200;
+const int CRASH_MAX_MS = 1000;
+const int CRASH_MAX_WRITES = NUM_DOCUMENTS * 100;
+
+// SQLite durability settings compared by the crash phase, applied as PRAGMAs
+const std::vector<std::string> SQLITE_CRASH_SETTINGS = {"synchronous=OFF", "synchronous=NORMAL", "synchronous=FULL"};
+
+// Document size class the builder phase builds, whatever --doc-size selects; the flat
+// builder only writes the filler-free default shape
+const std::string BUILDER_SHAPE = "default";
+
+// Scan, export and import settings
+const std::string EXPORT_PATH = "./benchmark_export";
+const std::string IMPORT_FILE_PATH = "./benchmark_import.jsonl";
+
+// Extra phases selectable with --phase
+const std::vector<std::string> EXTRA_PHASES = {"index", "topk", "aggregate", "scan", "nested", "partial", "tombstone", "timeseries", "soak", "interference", "checkpoint", "coldstart", "crash", "builder", "encoding"};
+
+// Result rows, by operation name prefix, whose ops make up each extra phase's operation count
+// for --alloc-stats; rows of one phase measure different things, so only these are summed
+const std::vector<std::pair<std::string, std::string>> PHASE_OPERATION_RESULTS = {
+    {"index", "Insert "}, {"topk", "TopK "}, {"aggregate", "Aggregate total"}, {"scan", "Scan all"},
+    {"nested", "Eq "}, {"partial", "Partial "}, {"tombstone", "Deleted reads"}, {"timeseries", "TS append"},
+    {"soak", "Soak mixed"}, {"interference", "RW point read"}, {"checkpoint", "WAL writes"},
+    {"coldstart", "Cold point read"}, {"crash", "Acked "}, {"builder", "Build json"}, {"encoding", "Encode "}
+};
+
+// Shape of the filler that generateRandomProduct adds to each product
+struct DocumentShape {
+    std::string name;
+    int minBytes;         // Target serialized size range; 0 adds no filler
+    int maxBytes;
+    int nestingDepth;     // Levels of nested objects in each items[] entry
+    int arrayLength;      // Entries in the items[] array
+    int fieldCount;       // String fields in the attributes object
+};
+
+// Size classes selectable with --doc-size. "mixed" draws a class per document
+// using MIXED_SHAPE_WEIGHTS, giving a long-tailed size distribution.
+const std::vector<DocumentShape> DOCUMENT_SHAPES = {
+    {"default", 0, 0, 0, 0, 0},                     // The plain product, about 250-400 bytes
+    {"small", 1024, 2048, 1, 4, 4},
+    {"medium", 8 * 1024, 16 * 1024, 2, 16, 8},
+    {"large", 64 * 1024, 128 * 1024, 3, 64, 16},
+    {"xlarge", 256 * 1024, 512 * 1024, 4, 128, 16}
+};
+const std::vector<int> MIXED_SHAPE_WEIGHTS = {60, 25, 10, 4, 1};  // Percent per DOCUMENT_SHAPES entry
+const int BASE_PRODUCT_BYTES = 320;       // Typical serialized size of a product without filler
+
+// Document id formats selectable with --key-format
+const std::vector<std::string> KEY_FORMATS = {"legacy", "seq", "random", "uuid4", "uuid7", "composite"};
+
+// Fixed timestamp (2024-01-01T00:00:00Z) uuid7 ids count from, so the crash writer and its
+// parent process build the same ids
+const uint64_t UUID7_EPOCH_MS = 1704067200000ULL;
+
+// SQLite table layouts selectable with --sqlite-schema
+//   shadow         JSON text plus hand-maintained copies of the indexed fields (the original layout)
+//   generated      JSON text plus virtual generated columns over json_extract
+//   expression     JSON text only, indexes on json_extract expressions
+//   jsonb          JSONB blob only, indexes on json_extract expressions (SQLite 3.45+)
+//   without-rowid  shadow columns in a WITHOUT ROWID table clustered on id
+const std::vector<std::string> SQLITE_SCHEMAS = {"shadow", "generated", "expression", "jsonb", "without-rowid"};
+
+// How the SQLite backend hands documents to and from SQLite, selectable with --sqlite-bind
+//   transient  binds copied by SQLite (SQLITE_TRANSIENT), a fresh dump() per document and
+//              documents read through sqlite3_column_text (the original path)
+//   static     binds of buffers that outlive the step (SQLITE_STATIC), one reused
+//              serialization buffer per thread and documents parsed in place from
+//              sqlite3_column_blob/sqlite3_column_bytes
+const std::vector<std::string> SQLITE_BIND_MODES = {"transient", "static"};
+
+// Document encodings compared by the encoding phase: JSON text and nlohmann's binary formats
+const std::vector<std::string> DOCUMENT_ENCODINGS = {"json", "cbor", "msgpack", "bson", "ubjson"};
+const double ENCODING_QUERY_WIDTH = 100.0;  // Width of each price range queried per encoding
+
+// Runtime options, filled in from the command line by main()
+struct BenchmarkOptions {
+    std::vector<std::string> phases;      // Extra phases to run after the core tests
+    int indexBuildDocuments = NUM_INDEX_BUILD_DOCUMENTS;
+    int scanThreads = 0;                  // Threads for the partitioned scan, 0 to skip it
+    std::string keyFormat = "legacy";     // One of KEY_FORMATS
+    std::string docSize = "default";      // A DOCUMENT_SHAPES name or "mixed"
+    int docNesting = -1;                  // Overrides for the selected shape, -1 keeps the preset
+    int docArrayLength = -1;
+    int docFields = -1;
+    std::string sqliteSchema = "shadow";  // One of SQLITE_SCHEMAS
+    std::string sqliteCheckpoint = "default";  // One of SQLITE_CHECKPOINTS or auto-N
+    std::string sqliteBind = "transient";  // One of SQLITE_BIND_MODES
+    std::vector<std::string> encodings = DOCUMENT_ENCODINGS;  // Compared by the encoding phase
+    int cacheMb = 0;                      // Cache budget per engine in MB, 0 for engine defaults
+    bool mmap = false;                    // Memory-mapped reads where the engine allows them
+    bool ioStats = false;                 // Count SQLite I/O through the accounting VFS
+    size_t storageProfile = 0;            // Index into STORAGE_PROFILES
+    int cores = 0;                        // Cores the whole benchmark may use, 0 for all
+    bool pinThreads = false;              // Pin each parallel worker to one allowed core
+    int addressSpaceMb = 0;               // RLIMIT_AS cap in MB, 0 for none
+    bool allocStats = false;              // Count heap allocations per phase
+    int tsDuration = 30;                  // Time-series run length in seconds
+    int tsRate = 1000;                    // Target appends per second, 0 for unthrottled
+    int tsRetention = 10;                 // Seconds a reading is kept before expiry
+    int tsWindow = 5;                     // Seconds covered by each time-window query
+    int soakDuration = 3600;              // Soak run length in seconds
+    int soakStallPercent = 25;            // A second below this percent of the median ops/s is a stall
+    std::string soakFormat = "csv";       // Soak timeline format: csv or json (JSON lines)
+    std::vector<int> rwWriteRates = {0, 100, 1000, 5000};  // Total writes/s; 0 runs readers alone
+    int rwReaders = 2;
+    int rwWriters = 2;
+    std::string crashWriter;              // ENGINE,SETTING,FD when running as the crash phase's writer
+
+    bool runPhase(const std::string& name) const {
+        return std::find(phases.begin(), phases.end(), name) != phases.end();
+    }
+};
+
+BenchmarkOptions benchmarkOptions;
+
+// SplitMix64 finalizer: a cheap, well-distributed 64-bit hash
+uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// FNV-1a hash of a string, stable across runs and platforms
+uint64_t hashString(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : text) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Format a 128-bit value as a canonical 8-4-4-4-12 UUID string into buffer (37 bytes)
+void formatUuid(uint64_t hi, uint64_t lo, char* buffer) {
+    std::snprintf(buffer, 37, "%08x-%04x-%04x-%04x-%012llx",
+                  static_cast<unsigned>(hi >> 32), static_cast<unsigned>((hi >> 16) & 0xffff),
+                  static_cast<unsigned>(hi & 0xffff), static_cast<unsigned>(lo >> 48),
+                  static_cast<unsigned long long>(lo & 0xffffffffffffULL));
+}
+
+// Document id for index in the selected key format, written into out so a caller reusing
+// one string allocates only while its buffer grows. Every format is a pure function of
+// (prefix, index), so later phases and the crash writer address the same documents.
+//   legacy     prefix + index, e.g. "prod42" (not lexicographically ordered)
+//   seq        prefix + zero-padded index, e.g. "prod0000000042"
+//   random     prefix + random 64-bit value in hex
+//   uuid4      random UUID (version 4)
+//   uuid7      time-ordered UUID (version 7), one millisecond per index from UUID7_EPOCH_MS
+//   composite  long tenant/site/device hierarchy ending in the sequential id
+void makeDocId(const std::string& prefix, int index, std::string& out) {
+    const std::string& format = benchmarkOptions.keyFormat;
+    char buffer[96];
+    uint64_t seed = hashString(prefix);
+    uint64_t random = mix64(seed + static_cast<uint64_t>(index));
+    if (format == "seq") {
+        std::snprintf(buffer, sizeof(buffer), "%s%010d", prefix.c_str(), index);
+    } else if (format == "random") {
+        std::snprintf(buffer, sizeof(buffer), "%s%016llx", prefix.c_str(), static_cast<unsigned long long>(random));
+    } else if (format == "uuid4") {
+        uint64_t hi = (random & ~0xf000ULL) | 0x4000ULL;
+        uint64_t lo = (mix64(random) & 0x3fffffffffffffffULL) | 0x8000000000000000ULL;
+        formatUuid(hi, lo, buffer);
+    } else if (format == "uuid7") {
+        uint64_t millis = (UUID7_EPOCH_MS + static_cast<uint64_t>(index)) & 0xffffffffffffULL;
+        uint64_t hi = (millis << 16) | 0x7000ULL | (random & 0x0fffULL);
+        uint64_t lo = (mix64(random) & 0x3fffffffffffffffULL) | 0x8000000000000000ULL;
+        formatUuid(hi, lo, buffer);
+    } else if (format == "composite") {
+        std::snprintf(buffer, sizeof(buffer), "tenant-%04d/site-%03d/device-%06d/%s%010d",
+                      static_cast<int>(random % 64), static_cast<int>((random >> 16) % 256),
+                      static_cast<int>((random >> 32) % 100000), prefix.c_str(), index);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%s%d", prefix.c_str(), index);
+    }
+    out.assign(buffer);
+}
+
+std::string makeDocId(const std::string& prefix, int index) {
+    std::string id;
+    makeDocId(prefix, index, id);
+    return id;
+}
+
+// Total size in bytes of a file, or of every file below a directory
+uint64_t pathSizeBytes(const std::string& path) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0) return 0;
+    if (!S_ISDIR(st.st_mode)) return st.st_size;
+
+    uint64_t total = 0;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return 0;
+    while (struct dirent* entry = readdir(dir)) {
+        if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0) {
+            total += pathSizeBytes(path + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+    return total;
+}
+
+// Total size in bytes of the files directly in dir whose names end in suffix
+uint64_t filesSizeBytes(const std::string& dir, const std::string& suffix) {
+    uint64_t total = 0;
+    DIR* handle = opendir(dir.c_str());
+    if (!handle) return 0;
+    while (struct dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            total += pathSizeBytes(dir + "/" + name);
+        }
+    }
+    closedir(handle);
+    return total;
+}
+
+// Write back a file, or every file below a directory, and drop it from the page cache so
+// the next read comes from storage; returns the bytes covered
+uint64_t evictPageCache(const std::string& path) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0) return 0;
+    if (S_ISDIR(st.st_mode)) {
+        uint64_t total = 0;
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return 0;
+        while (struct dirent* entry = readdir(dir)) {
+            if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0) {
+                total += evictPageCache(path + "/" + entry->d_name);
+            }
+        }
+        closedir(dir);
+        return total;
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return 0;
+    // DONTNEED only drops clean pages, so flush dirty ones first
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    return st.st_size;
+}
+
+// Cores the calling thread may run on
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) return cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// Resident set size of this process in bytes, 0 where /proc is unavailable
+uint64_t currentRssBytes() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0;
+    uint64_t residentPages = 0;
+    if (!(statm >> sizePages >> residentPages)) return 0;
+    return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Highest resident set size of this process since it started or since resetPeakRss(), in
+// bytes, 0 where /proc is unavailable
+uint64_t peakRssBytes() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+        }
+    }
+    return 0;
+}
+
+// Restart the peak RSS at the current RSS (Linux 4.0+); false where the kernel refuses
+bool resetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.flush();
+    return clearRefs.good();
+}
+
+// Remove a file, or a directory and everything below it
+void removePath(const std::string& path) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0) return;
+    if (S_ISDIR(st.st_mode)) {
+        DIR* dir = opendir(path.c_str());
+        if (dir) {
+            while (struct dirent* entry = readdir(dir)) {
+                if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0) {
+                    removePath(path + "/" + entry->d_name);
+                }
+            }
+            closedir(dir);
+        }
+        rmdir(path.c_str());
+    } else {
+        std::remove(path.c_str());
+    }
+}
+
+// Sum of a column of doubles using the widest vector unit available at compile time.
+// Four independent accumulators hide the add latency on every path.
+double sumColumn(const double* values, size_t count) {
+    size_t i = 0;
+    double sum = 0;
+#if defined(__SSE2__)
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(values + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(values + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    sum = lanes[0] + lanes[1];
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    float64x2_t acc0 = vdupq_n_f64(0);
+    float64x2_t acc1 = vdupq_n_f64(0);
+    for (; i + 4 <= count; i += 4) {
+        acc0 = vaddq_f64(acc0, vld1q_f64(values + i));
+        acc1 = vaddq_f64(acc1, vld1q_f64(values + i + 2));
+    }
+    sum = vaddvq_f64(vaddq_f64(acc0, acc1));
+#else
+    double acc[4] = {0, 0, 0, 0};
+    for (; i + 4 <= count; i += 4) {
+        acc[0] += values[i];
+        acc[1] += values[i + 1];
+        acc[2] += values[i + 2];
+        acc[3] += values[i + 3];
+    }
+    sum = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+    for (; i < count; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+// Collects per-operation latencies and summarizes them as percentiles
+class LatencyStats {
+public:
+    void add(double micros) {
+        samples.push_back(micros);
+        totalMicros += micros;
+    }
+
+    void merge(const LatencyStats& other) {
+        samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+        totalMicros += other.totalMicros;
+    }
+
+    size_t count() const { return samples.size(); }
+    double totalSeconds() const { return totalMicros / 1000000.0; }
+
+    // Nearest-rank percentile in milliseconds
+    double percentileMs(double p) const {
+        if (samples.empty()) return 0;
+        std::vector<double> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+        return sorted[rank > 0 ? rank - 1 : 0] / 1000.0;
+    }
+
+private:
+    std::vector<double> samples;
+    double totalMicros = 0;
+};
+
+// Latency histogram with power-of-two microsecond buckets, cheap enough to update on every
+// I/O call; a percentile is reported as the upper bound of the bucket it falls in
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 32;
+
+    void add(double micros) {
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && micros >= static_cast<double>(1ULL << bucket)) {
+            bucket++;
+        }
+        counts[bucket]++;
+        total++;
+    }
+
+    uint64_t count() const { return total; }
+
+    double percentileMs(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * total)));
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < BUCKETS; bucket++) {
+            seen += counts[bucket];
+            if (seen >= rank) return (1ULL << bucket) / 1000.0;
+        }
+        return (1ULL << (BUCKETS - 1)) / 1000.0;
+    }
+
+private:
+    uint64_t counts[BUCKETS] = {};
+    uint64_t total = 0;
+};
+
+// File types the I/O accounting VFS tells apart, from the flags SQLite opens each file with
+enum IoFileType { IO_MAIN_DB, IO_WAL, IO_JOURNAL, IO_TEMP, IO_OTHER, IO_FILE_TYPES };
+const char* const IO_FILE_TYPE_NAMES[IO_FILE_TYPES] = {"main", "wal", "journal", "temp", "other"};
+
+// Calls, bytes and call latency of the I/O on one file type
+struct IoTypeStats {
+    uint64_t reads = 0;
+    uint64_t readBytes = 0;
+    uint64_t writes = 0;
+    uint64_t writeBytes = 0;
+    uint64_t syncs = 0;
+    LatencyHistogram readLatency;
+    LatencyHistogram writeLatency;
+    LatencyHistogram syncLatency;
+};
+
+// I/O counted by the accounting VFS since the last takeIoStats(), per IoFileType
+std::mutex ioStatsMutex;
+IoTypeStats ioStats[IO_FILE_TYPES];
+
+std::vector<IoTypeStats> takeIoStats() {
+    std::lock_guard<std::mutex> lock(ioStatsMutex);
+    std::vector<IoTypeStats> taken(ioStats, ioStats + IO_FILE_TYPES);
+    for (auto& stats : ioStats) {
+        stats = IoTypeStats();
+    }
+    return taken;
+}
+
+// Syscall-level I/O of the whole process from /proc/self/io, zero where it is unavailable
+struct ProcessIo {
+    uint64_t readCalls = 0;
+    uint64_t readBytes = 0;
+    uint64_t writeCalls = 0;
+    uint64_t writeBytes = 0;
+};
+
+ProcessIo currentProcessIo() {
+    ProcessIo io;
+    std::ifstream in("/proc/self/io");
+    std::string key;
+    uint64_t value;
+    while (in >> key >> value) {
+        if (key == "rchar:") io.readBytes = value;
+        else if (key == "wchar:") io.writeBytes = value;
+        else if (key == "syscr:") io.readCalls = value;
+        else if (key == "syscw:") io.writeCalls = value;
+    }
+    return io;
+}
+
+// SQLite file handle of the accounting VFS; the wrapped VFS's own handle follows it in memory
+struct IoFile {
+    sqlite3_file base;
+    sqlite3_file* real;
+    IoFileType type;
+};
+
+enum IoCall { IO_READ, IO_WRITE, IO_SYNC };
+
+sqlite3_vfs* ioRealVfs = nullptr;
+
+// Time at which the emulated device finishes the calls queued on it so far
+std::mutex storageMutex;
+steady_clock::time_point storageBusyUntil;
+
+// Hold the calling thread until the emulated device has served an I/O call of kind and size
+void emulateStorage(IoCall kind, uint64_t bytes) {
+    const StorageProfile& profile = STORAGE_PROFILES[benchmarkOptions.storageProfile];
+    double latencyUs = kind == IO_READ ? profile.readLatencyUs : kind == IO_WRITE ? profile.writeLatencyUs : profile.syncLatencyUs;
+    double mbps = kind == IO_READ ? profile.readMBps : kind == IO_WRITE ? profile.writeMBps : 0;
+    // 1 MB/s moves one byte per microsecond
+    double micros = latencyUs + (mbps > 0 ? bytes / mbps : 0);
+    if (micros <= 0) return;
+
+    steady_clock::time_point done;
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        done = std::max(steady_clock::now(), storageBusyUntil) +
+               duration_cast<steady_clock::duration>(duration<double, std::micro>(micros));
+        storageBusyUntil = done;
+    }
+    std::this_thread::sleep_until(done);
+}
+
+sqlite3_file* ioReal(sqlite3_file* file) {
+    return reinterpret_cast<IoFile*>(file)->real;
+}
+
+// Run call on the wrapped file handle plus any emulated device time, timing both and
+// counting the call against the file's type
+template <typename Call>
+int accountIo(sqlite3_file* file, IoCall kind, uint64_t bytes, Call call) {
+    IoFile* io = reinterpret_cast<IoFile*>(file);
+    auto start = steady_clock::now();
+    int rc = call(io->real);
+    emulateStorage(kind, bytes);
+    double micros = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1000.0;
+
+    std::lock_guard<std::mutex> lock(ioStatsMutex);
+    IoTypeStats& stats = ioStats[io->type];
+    if (kind == IO_READ) {
+        stats.reads++;
+        stats.readBytes += bytes;
+        stats.readLatency.add(micros);
+    } else if (kind == IO_WRITE) {
+        stats.writes++;
+        stats.writeBytes += bytes;
+        stats.writeLatency.add(micros);
+    } else {
+        stats.syncs++;
+        stats.syncLatency.add(micros);
+    }
+    return rc;
+}
+
+int ioClose(sqlite3_file* file) {
+    return ioReal(file)->pMethods->xClose(ioReal(file));
+}
+
+int ioRead(sqlite3_file* file, void* buffer, int amount, sqlite3_int64 offset) {
+    return accountIo(file, IO_READ, amount, [&](sqlite3_file* real) {
+        return real->pMethods->xRead(real, buffer, amount, offset);
+    });
+}
+
+int ioWrite(sqlite3_file* file, const void* buffer, int amount, sqlite3_int64 offset) {
+    return accountIo(file, IO_WRITE, amount, [&](sqlite3_file* real) {
+        return real->pMethods->xWrite(real, buffer, amount, offset);
+    });
+}
+
+int ioSync(sqlite3_file* file, int flags) {
+    return accountIo(file, IO_SYNC, 0, [&](sqlite3_file* real) {
+        return real->pMethods->xSync(real, flags);
+    });
+}
+
+// The remaining file methods pass straight through; the default unix and win32 VFSes
+// implement all of them, shared memory and memory-mapped fetches included
+int ioTruncate(sqlite3_file* file, sqlite3_int64 size) {
+    return ioReal(file)->pMethods->xTruncate(ioReal(file), size);
+}
+
+int ioFileSize(sqlite3_file* file, sqlite3_int64* size) {
+    return ioReal(file)->pMethods->xFileSize(ioReal(file), size);
+}
+
+int ioLock(sqlite3_file* file, int lock) {
+    return ioReal(file)->pMethods->xLock(ioReal(file), lock);
+}
+
+int ioUnlock(sqlite3_file* file, int lock) {
+    return ioReal(file)->pMethods->xUnlock(ioReal(file), lock);
+}
+
+int ioCheckReservedLock(sqlite3_file* file, int* reserved) {
+    return ioReal(file)->pMethods->xCheckReservedLock(ioReal(file), reserved);
+}
+
+int ioFileControl(sqlite3_file* file, int op, void* arg) {
+    return ioReal(file)->pMethods->xFileControl(ioReal(file), op, arg);
+}
+
+int ioSectorSize(sqlite3_file* file) {
+    return ioReal(file)->pMethods->xSectorSize(ioReal(file));
+}
+
+int ioDeviceCharacteristics(sqlite3_file* file) {
+    return ioReal(file)->pMethods->xDeviceCharacteristics(ioReal(file));
+}
+
+int ioShmMap(sqlite3_file* file, int region, int size, int extend, void volatile** mapped) {
+    return ioReal(file)->pMethods->xShmMap(ioReal(file), region, size, extend, mapped);
+}
+
+int ioShmLock(sqlite3_file* file, int offset, int count, int flags) {
+    return ioReal(file)->pMethods->xShmLock(ioReal(file), offset, count, flags);
+}
+
+void ioShmBarrier(sqlite3_file* file) {
+    ioReal(file)->pMethods->xShmBarrier(ioReal(file));
+}
+
+int ioShmUnmap(sqlite3_file* file, int deleteFlag) {
+    return ioReal(file)->pMethods->xShmUnmap(ioReal(file), deleteFlag);
+}
+
+int ioFetch(sqlite3_file* file, sqlite3_int64 offset, int amount, void** page) {
+    return ioReal(file)->pMethods->xFetch(ioReal(file), offset, amount, page);
+}
+
+int ioUnfetch(sqlite3_file* file, sqlite3_int64 offset, void* page) {
+    return ioReal(file)->pMethods->xUnfetch(ioReal(file), offset, page);
+}
+
+const sqlite3_io_methods ioMethods = {
+    3, ioClose, ioRead, ioWrite, ioTruncate, ioSync, ioFileSize, ioLock, ioUnlock,
+    ioCheckReservedLock, ioFileControl, ioSectorSize, ioDeviceCharacteristics,
+    ioShmMap, ioShmLock, ioShmBarrier, ioShmUnmap, ioFetch, ioUnfetch
+};
+
+int ioOpen(sqlite3_vfs*, const char* name, sqlite3_file* file, int flags, int* outFlags) {
+    IoFile* io = reinterpret_cast<IoFile*>(file);
+    io->real = reinterpret_cast<sqlite3_file*>(io + 1);
+    if (flags & SQLITE_OPEN_MAIN_DB) {
+        io->type = IO_MAIN_DB;
+    } else if (flags & SQLITE_OPEN_WAL) {
+        io->type = IO_WAL;
+    } else if (flags & (SQLITE_OPEN_MAIN_JOURNAL | SQLITE_OPEN_SUPER_JOURNAL | SQLITE_OPEN_SUBJOURNAL)) {
+        io->type = IO_JOURNAL;
+    } else if (flags & (SQLITE_OPEN_TEMP_DB | SQLITE_OPEN_TEMP_JOURNAL | SQLITE_OPEN_TRANSIENT_DB)) {
+        io->type = IO_TEMP;
+    } else {
+        io->type = IO_OTHER;
+    }
+    int rc = ioRealVfs->xOpen(ioRealVfs, name, io->real, flags, outFlags);
+    // SQLite skips xClose on a handle whose pMethods is left null after a failed open
+    io->base.pMethods = io->real->pMethods ? &ioMethods : nullptr;
+    return rc;
+}
+
+int ioDelete(sqlite3_vfs*, const char* name, int syncDir) {
+    return ioRealVfs->xDelete(ioRealVfs, name, syncDir);
+}
+
+int ioAccess(sqlite3_vfs*, const char* name, int flags, int* result) {
+    return ioRealVfs->xAccess(ioRealVfs, name, flags, result);
+}
+
+int ioFullPathname(sqlite3_vfs*, const char* name, int size, char* out) {
+    return ioRealVfs->xFullPathname(ioRealVfs, name, size, out);
+}
+
+// Register the accounting VFS as SQLite's default, wrapping the previous default, so every
+// connection opened afterwards is counted and sees the --storage-profile device. The clock,
+// randomness and dynamic-loading methods are copied from the wrapped VFS, which ignores the
+// VFS pointer they are called with
+bool registerIoAccountingVfs() {
+    ioRealVfs = sqlite3_vfs_find(nullptr);
+    if (!ioRealVfs) return false;
+    static sqlite3_vfs vfs;
+    vfs = *ioRealVfs;
+    vfs.pNext = nullptr;
+    vfs.zName = "iostats";
+    vfs.szOsFile = static_cast<int>(sizeof(IoFile)) + ioRealVfs->szOsFile;
+    vfs.xOpen = ioOpen;
+    vfs.xDelete = ioDelete;
+    vfs.xAccess = ioAccess;
+    vfs.xFullPathname = ioFullPathname;
+    return sqlite3_vfs_register(&vfs, 1) == SQLITE_OK;
+}
+
+// Heap allocations counted with --alloc-stats, index 0 for the harness and 1 for the engines.
+// Each thread adds to its own cache-line-sized slot so the counters stay uncontended; threads
+// beyond the last slot share it. liveBytes is what the slot's thread allocated less what it
+// freed, negative when it frees other threads' blocks, so only the sum over slots is the heap
+struct alignas(64) AllocCounters {
+    std::atomic<uint64_t> allocations[2];
+    std::atomic<uint64_t> bytes[2];
+    std::atomic<int64_t> liveBytes;
+};
+
+// Totals over all threads since the process started counting
+struct AllocTotals {
+    uint64_t allocations[2] = {0, 0};
+    uint64_t bytes[2] = {0, 0};
+};
+
+const int ALLOC_SLOTS = 256;
+AllocCounters allocSlots[ALLOC_SLOTS];
+std::atomic<int> allocSlotsUsed(0);
+bool countingAllocations = false;
+thread_local int allocSlot = -1;
+thread_local int engineDepth = 0;
+
+// Marks the calling thread as inside an engine call, so its allocations count as the engine's
+struct EngineScope {
+    EngineScope() { engineDepth++; }
+    ~EngineScope() { engineDepth--; }
+};
+
+AllocCounters& threadAllocSlot() {
+    if (allocSlot < 0) {
+        allocSlot = std::min(allocSlotsUsed.fetch_add(1), ALLOC_SLOTS - 1);
+    }
+    return allocSlots[allocSlot];
+}
+
+void countAllocation(size_t bytes, bool engine) {
+    AllocCounters& counters = threadAllocSlot();
+    counters.allocations[engine].fetch_add(1, std::memory_order_relaxed);
+    counters.bytes[engine].fetch_add(bytes, std::memory_order_relaxed);
+    counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void countFree(size_t bytes) {
+    threadAllocSlot().liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+AllocTotals allocTotals() {
+    AllocTotals totals;
+    int used = std::min(allocSlotsUsed.load(), ALLOC_SLOTS);
+    for (int slot = 0; slot < used; slot++) {
+        for (int engine = 0; engine < 2; engine++) {
+            totals.allocations[engine] += allocSlots[slot].allocations[engine].load(std::memory_order_relaxed);
+            totals.bytes[engine] += allocSlots[slot].bytes[engine].load(std::memory_order_relaxed);
+        }
+    }
+    return totals;
+}
+
+// Bytes currently allocated through the counted allocators, summed over all slots
+int64_t liveHeapBytes() {
+    int64_t live = 0;
+    int used = std::min(allocSlotsUsed.load(), ALLOC_SLOTS);
+    for (int slot = 0; slot < used; slot++) {
+        live += allocSlots[slot].liveBytes.load(std::memory_order_relaxed);
+    }
+    return live;
+}
+
+const int HEAP_SAMPLE_MS = 1;         // Interval at which the peak live heap is sampled
+
+// Samples liveHeapBytes() every HEAP_SAMPLE_MS from start() to stop(), which returns the
+// highest value seen; a spike shorter than the interval can be missed, but the allocating
+// threads never touch shared state to track the peak
+class HeapPeakSampler {
+public:
+    void start() {
+        peak = liveHeapBytes();
+        running = true;
+        sampler = std::thread([this]() {
+            while (running) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(HEAP_SAMPLE_MS));
+                peak = std::max(peak.load(), liveHeapBytes());
+            }
+        });
+    }
+
+    int64_t stop() {
+        running = false;
+        sampler.join();
+        return std::max(peak.load(), liveHeapBytes());
+    }
+
+private:
+    std::thread sampler;
+    std::atomic<bool> running{false};
+    std::atomic<int64_t> peak{0};
+};
+
+// SQLite allocates through malloc rather than operator new, so its own allocator is wrapped
+// to count every SQLite allocation as the engine's, whichever thread makes it
+sqlite3_mem_methods sqliteMemory;
+
+void* countedSqliteMalloc(int size) {
+    void* block = sqliteMemory.xMalloc(size);
+    if (block) countAllocation(sqliteMemory.xSize(block), true);
+    return block;
+}
+
+void countedSqliteFree(void* block) {
+    if (block) countFree(sqliteMemory.xSize(block));
+    sqliteMemory.xFree(block);
+}
+
+void* countedSqliteRealloc(void* block, int size) {
+    int oldSize = block ? sqliteMemory.xSize(block) : 0;
+    void* resized = sqliteMemory.xRealloc(block, size);
+    if (resized) {
+        countFree(oldSize);
+        countAllocation(sqliteMemory.xSize(resized), true);
+    }
+    return resized;
+}
+
+int countedSqliteSize(void* block) { return sqliteMemory.xSize(block); }
+int countedSqliteRoundup(int size) { return sqliteMemory.xRoundup(size); }
+int countedSqliteInit(void*) { return sqliteMemory.xInit(sqliteMemory.pAppData); }
+void countedSqliteShutdown(void*) { sqliteMemory.xShutdown(sqliteMemory.pAppData); }
+
+// Start counting allocations. Must run before SQLite initializes, which the VFS
+// registration in main() triggers
+bool startAllocationCounting() {
+    static sqlite3_mem_methods counted;
+    if (sqlite3_config(SQLITE_CONFIG_GETMALLOC, &sqliteMemory) != SQLITE_OK) return false;
+    counted = sqliteMemory;
+    counted.xMalloc = countedSqliteMalloc;
+    counted.xFree = countedSqliteFree;
+    counted.xRealloc = countedSqliteRealloc;
+    counted.xSize = countedSqliteSize;
+    counted.xRoundup = countedSqliteRoundup;
+    counted.xInit = countedSqliteInit;
+    counted.xShutdown = countedSqliteShutdown;
+    if (sqlite3_config(SQLITE_CONFIG_MALLOC, &counted) != SQLITE_OK) return false;
+    countingAllocations = true;
+    return true;
+}
+
+void* countedNew(std::size_t size) {
+    void* block = std::malloc(size ? size : 1);
+    if (!block) throw std::bad_alloc();
+    if (countingAllocations) countAllocation(malloc_usable_size(block), engineDepth > 0);
+    return block;
+}
+
+void countedDelete(void* block) {
+    if (!block) return;
+    if (countingAllocations) countFree(malloc_usable_size(block));
+    std::free(block);
+}
+
+// Global operator new and delete replaced so --alloc-stats sees every C++ allocation,
+// the harness's and RocksDB's alike
+void* operator new(std::size_t size) { return countedNew(size); }
+void* operator new[](std::size_t size) { return countedNew(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return countedNew(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return countedNew(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* block) noexcept { countedDelete(block); }
+void operator delete[](void* block) noexcept { countedDelete(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { countedDelete(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { countedDelete(block); }
+void operator delete(void* block, std::size_t) noexcept { countedDelete(block); }
+void operator delete[](void* block, std::size_t) noexcept { countedDelete(block); }
 
 // Test case class for common functionality
 class BenchmarkTest {
@@ -52,6 +1016,25 @@ public:
     virtual bool runUpdateTest() = 0;
     virtual bool runDeleteTest() = 0;
     virtual bool runParallelTest() = 0;
+    virtual bool runIndexTest() = 0;
+    virtual bool runTopKTest() = 0;
+    virtual bool runAggregationTest() = 0;
+    virtual bool runScanTest() = 0;
+    virtual bool runNestedQueryTest() = 0;
+    virtual bool runPartialUpdateTest() = 0;
+    virtual bool runTombstoneTest() = 0;
+    virtual bool runTimeSeriesTest() = 0;
+    virtual bool runSoakTest() = 0;
+    virtual bool runInterferenceTest() = 0;
+    virtual bool runCheckpointTest() = 0;
+    virtual bool runColdStartTest() = 0;
+    virtual bool runCrashTest() = 0;
+    virtual bool runBuilderTest() = 0;
+    virtual bool runEncodingTest() = 0;
+    // Write products to a fresh crash-phase store under setting until killed, writing each
+    // acknowledged product index to ackFd
+    virtual bool runCrashWriter(const std::string& setting, int ackFd) = 0;
+    virtual uint64_t footprintBytes() = 0;
     
     const std::string& getName() const { return testName; }
     
@@ -67,43 +1050,827 @@ public:
         size_t updateOps = 0;
         size_t deleteOps = 0;
         size_t parallelOps = 0;
+        uint64_t insertBytes = 0;         // Document bytes written or returned, 0 when not measured
+        uint64_t queryBytes = 0;
+        uint64_t updateBytes = 0;
+        uint64_t parallelBytes = 0;
+        uint64_t footprintBytes = 0;      // On-disk size after all phases
+        uint64_t rssBytes = 0;            // RSS added since before setup, after all phases with the engine open
+        uint64_t peakRssBytes = 0;        // Peak RSS during the run above the RSS before setup, 0 if unknown
     };
     
     TestResult results;
 
+    // Page faults a phase caused and the process RSS after it
+    struct ResourceSample {
+        std::string phase;
+        long minorFaults;
+        long majorFaults;
+        uint64_t rssBytes;
+    };
+
+    std::vector<ResourceSample> resourceUsage;
+
+    // I/O of one phase with --io-stats=on
+    struct IoSample {
+        std::string phase;
+        std::vector<IoTypeStats> files;   // Per IoFileType, counted by the accounting VFS
+        ProcessIo process;                // Whole-process syscall I/O over the phase
+    };
+
+    std::vector<IoSample> ioUsage;
+
+    // Heap allocations of one phase with --alloc-stats=on, harness and engine apart
+    struct AllocSample {
+        std::string phase;
+        size_t operations;
+        AllocTotals totals;
+        uint64_t peakHeapBytes;
+    };
+
+    std::vector<AllocSample> allocUsage;
+
+    // Operations a phase performed: the core result for the core phases, otherwise the ops
+    // of the results recorded from firstResult on that PHASE_OPERATION_RESULTS names for it
+    size_t phaseOperations(const std::string& phase, size_t firstResult) const {
+        if (phase == "Insert") return results.insertOps;
+        if (phase == "Query") return results.queryOps;
+        if (phase == "Update") return results.updateOps;
+        if (phase == "Delete") return results.deleteOps;
+        if (phase == "Parallel") return results.parallelOps;
+        auto designated = std::find_if(PHASE_OPERATION_RESULTS.begin(), PHASE_OPERATION_RESULTS.end(),
+            [&](const std::pair<std::string, std::string>& entry) { return entry.first == phase; });
+        if (designated == PHASE_OPERATION_RESULTS.end()) return 0;
+        size_t operations = 0;
+        for (size_t i = firstResult; i < phaseResults.size(); i++) {
+            if (phaseResults[i].operation.compare(0, designated->second.size(), designated->second) == 0) {
+                operations += phaseResults[i].ops;
+            }
+        }
+        return operations;
+    }
+
+    // Results of the extra phases, one row per measured operation
+    struct PhaseResult {
+        std::string operation;
+        double time;
+        size_t ops;
+        uint64_t bytes;                   // Payload bytes moved, 0 when not measured
+        bool hasLatency;
+        double p50Ms;
+        double p99Ms;
+    };
+
+    std::vector<PhaseResult> phaseResults;
+
 protected:
     std::string testName;
+
+    void recordPhaseResult(const std::string& operation, double time, size_t ops, uint64_t bytes = 0) {
+        PhaseResult result;
+        result.operation = operation;
+        result.time = time;
+        result.ops = ops;
+        result.bytes = bytes;
+        result.hasLatency = false;
+        result.p50Ms = 0;
+        result.p99Ms = 0;
+        phaseResults.push_back(result);
+    }
+
+    void recordPhaseResult(const std::string& operation, const LatencyStats& latency) {
+        recordPhaseResult(operation, latency.totalSeconds(), latency.count());
+        PhaseResult& result = phaseResults.back();
+        result.hasLatency = true;
+        result.p50Ms = latency.percentileMs(50);
+        result.p99Ms = latency.percentileMs(99);
+    }
     
-    // Helper method to generate random product data
-    json generateRandomProduct(int index) {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<> price_dist(10.0, 2000.0);
-        static std::uniform_int_distribution<> stock_dist(0, 500);
-        static std::uniform_real_distribution<> rating_dist(1.0, 5.0);
-        static std::uniform_int_distribution<> category_dist(0, 3);
-        
-        const std::vector<std::string> categories = {"Electronics", "Books", "Food", "Clothing"};
-        const std::vector<std::string> brands = {"TechMaster", "ReadBooks", "FoodDelight", "FashionStyle"};
+    // Record a partial update result with the document bytes rewritten by the engine and the
+    // bytes that crossed the client boundary, and print both per update
+    void recordPartialUpdate(const std::string& operation, const LatencyStats& latency,
+                             uint64_t rewrittenBytes, uint64_t clientBytes) {
+        recordPhaseResult(operation, latency);
+        phaseResults.back().bytes = rewrittenBytes;
+        size_t ops = std::max<size_t>(1, latency.count());
+        std::cout << "    " << testName << " " << operation << ": " << rewrittenBytes / ops
+                  << " bytes rewritten/update, " << clientBytes / ops << " bytes to/from client/update" << std::endl;
+    }
+    
+    // Wall-clock milliseconds since the epoch, the timestamp stored in each reading
+    static int64_t nowMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    
+    // Sensor reading number seq taken at tsMs
+    static json generateReading(size_t seq, int64_t tsMs) {
+        return {
+            {"id", makeDocId("reading", seq)},
+            {"sensor", "sensor" + std::to_string(seq % TS_SENSORS)},
+            {"ts", tsMs},
+            {"value", std::round(std::sin(seq * 0.01) * 10000.0) / 100.0}
+        };
+    }
+    
+    // Call append(seq, tsMs) at the --ts-rate target (back to back when 0) for
+    // --ts-duration seconds and return how many appends were issued
+    template <typename Append>
+    static size_t paceAppends(Append append) {
+        auto start = std::chrono::steady_clock::now();
+        auto end = start + std::chrono::seconds(benchmarkOptions.tsDuration);
+        size_t seq = 0;
+        while (std::chrono::steady_clock::now() < end) {
+            if (benchmarkOptions.tsRate > 0) {
+                auto due = start + std::chrono::microseconds(seq * 1000000 / benchmarkOptions.tsRate);
+                if (due > std::chrono::steady_clock::now()) {
+                    std::this_thread::sleep_until(std::min(due, end));
+                    continue;
+                }
+            }
+            append(seq, nowMillis());
+            seq++;
+        }
+        return seq;
+    }
+    
+    // Print the sustained rate and footprint of a time-series run
+    void reportTimeSeries(size_t appended, double ingestTime, size_t expired, uint64_t peakBytes, uint64_t finalBytes) {
+        std::cout << "    " << testName << " time-series: " << appended << " appended in " << std::fixed
+                  << std::setprecision(1) << ingestTime << " s (" << (ingestTime > 0 ? appended / ingestTime : 0)
+                  << "/s sustained, target " << benchmarkOptions.tsRate << "/s), " << expired << " expired, footprint peak "
+                  << std::setprecision(2) << peakBytes / (1024.0 * 1024.0) << " MB, final "
+                  << finalBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+    }
+    
+    // Soak loop over a collection preloaded with products 0..preloaded-1. apply(op, index, product)
+    // performs one operation on product index; product is the document to store for SOAK_INSERT.
+    // Each second is written to the timeline file as it closes; stalls are summarized at the end.
+    template <typename Apply>
+    bool soakLoop(int preloaded, Apply apply) {
+        std::string timelinePath = SOAK_TIMELINE_PREFIX + testName + (benchmarkOptions.soakFormat == "json" ? ".jsonl" : ".csv");
+        std::ofstream timeline(timelinePath.c_str());
+        if (!timeline) {
+            std::cerr << "Failed to open soak timeline " << timelinePath << std::endl;
+            return false;
+        }
+        if (benchmarkOptions.soakFormat == "csv") {
+            timeline << "second,ops,ops_per_sec,p50_ms,p99_ms,max_ms,rss_bytes,disk_bytes\n";
+        }
         
-        int category_idx = category_dist(gen);
-        double price = std::round(price_dist(gen) * 100.0) / 100.0;
-        int stock = stock_dist(gen);
-        double rating = std::round(rating_dist(gen) * 10.0) / 10.0;
+        std::mt19937 gen(13);
+        std::uniform_int_distribution<> percent_dist(0, 99);
+        int low = 0;                      // Live products are [low, high)
+        int high = preloaded;
+        std::vector<double> bucket;       // Latencies in microseconds completed in the current second
+        std::vector<double> opsPerSecond;
+        size_t totalOps = 0;
         
-        json product = {
-            {"id", "prod" + std::to_string(index)},
-            {"name", "Product " + std::to_string(index)},
-            {"price", price},
-            {"stock", stock},
-            {"category", categories[category_idx]},
-            {"brand", brands[category_idx]},
-            {"rating", rating},
-            {"available", (stock > 0)},
-            {"created_at", getCurrentTimeString()}
+        // Close the current second: write its timeline entry and start the next one
+        auto closeBucket = [&]() {
+            std::sort(bucket.begin(), bucket.end());
+            auto rank = [&](double p) {
+                size_t r = static_cast<size_t>(std::ceil(p / 100.0 * bucket.size()));
+                return bucket.empty() ? 0.0 : bucket[r > 0 ? r - 1 : 0] / 1000.0;
+            };
+            double maxMs = bucket.empty() ? 0.0 : bucket.back() / 1000.0;
+            uint64_t rss = currentRssBytes();
+            uint64_t disk = footprintBytes();
+            size_t second = opsPerSecond.size();
+            if (benchmarkOptions.soakFormat == "json") {
+                json entry = {{"second", second}, {"ops", bucket.size()}, {"ops_per_sec", bucket.size()},
+                              {"p50_ms", rank(50)}, {"p99_ms", rank(99)}, {"max_ms", maxMs},
+                              {"rss_bytes", rss}, {"disk_bytes", disk}};
+                timeline << entry.dump() << "\n";
+            } else {
+                timeline << second << "," << bucket.size() << "," << bucket.size() << "," << rank(50) << ","
+                         << rank(99) << "," << maxMs << "," << rss << "," << disk << "\n";
+            }
+            timeline.flush();
+            opsPerSecond.push_back(static_cast<double>(bucket.size()));
+            bucket.clear();
         };
         
-        // Add category-specific attributes
+        auto start = std::chrono::steady_clock::now();
+        auto end = start + std::chrono::seconds(benchmarkOptions.soakDuration);
+        while (std::chrono::steady_clock::now() < end) {
+            // Pick an operation by weight; keep at least one product live so reads have a target
+            int draw = percent_dist(gen);
+            int op = 0;
+            while (draw >= SOAK_MIX_WEIGHTS[op]) {
+                draw -= SOAK_MIX_WEIGHTS[op];
+                op++;
+            }
+            if (op == SOAK_DELETE && high - low <= 1) op = SOAK_INSERT;
+            
+            int index = op == SOAK_INSERT ? high : op == SOAK_DELETE ? low
+                      : std::uniform_int_distribution<>(low, high - 1)(gen);
+            json product = op == SOAK_INSERT ? generateRandomProduct(index) : json();
+            bucket.push_back(measureLatency([&]() {
+                apply(static_cast<SoakOp>(op), index, product);
+            }));
+            if (op == SOAK_INSERT) high++;
+            if (op == SOAK_DELETE) low++;
+            totalOps++;
+            
+            // An operation longer than a second leaves the seconds it spanned empty
+            size_t elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::steady_clock::now() - start).count();
+            while (opsPerSecond.size() < elapsed) {
+                closeBucket();
+            }
+        }
+        if (!bucket.empty()) {
+            closeBucket();
+        }
+        
+        // Stalls: runs of consecutive seconds below the threshold fraction of the median rate
+        std::vector<double> sorted(opsPerSecond);
+        std::sort(sorted.begin(), sorted.end());
+        double median = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+        double threshold = median * benchmarkOptions.soakStallPercent / 100.0;
+        size_t stalls = 0;
+        size_t stalledSeconds = 0;
+        size_t longest = 0;
+        size_t run = 0;
+        for (double rate : opsPerSecond) {
+            if (rate < threshold) {
+                stalledSeconds++;
+                if (run++ == 0) stalls++;
+                longest = std::max(longest, run);
+            } else {
+                run = 0;
+            }
+        }
+        
+        recordPhaseResult("Soak mixed", static_cast<double>(opsPerSecond.size()), totalOps);
+        recordPhaseResult("Soak stalls", static_cast<double>(stalledSeconds), stalls);
+        std::cout << "    " << testName << " soak: " << totalOps << " ops over " << opsPerSecond.size()
+                  << " s, median " << median << " ops/s; " << stalls << " stalls below " << threshold
+                  << " ops/s covering " << stalledSeconds << " s (longest " << longest << " s); timeline in "
+                  << timelinePath << std::endl;
+        return true;
+    }
+    
+    // Reader latency at each --rw-write-rates rate. read(thread, range, index) runs a point lookup
+    // of product index, or a price range query starting near it when range is set.
+    // write(thread, insert, docId, product) inserts product as a new document docId, or when
+    // insert is false sets the price and stock of existing product docId to product's, the
+    // same two-field change on both engines; writers alternate the two.
+    template <typename Read, typename Write>
+    void interferenceLoop(Read read, Write write) {
+        std::vector<json> pool;
+        for (int i = 0; i < RW_WRITE_POOL; i++) {
+            pool.push_back(generateRandomProduct(i));
+        }
+        
+        for (int rate : benchmarkOptions.rwWriteRates) {
+            const std::string suffix = " w=" + std::to_string(rate) + "/s";
+            auto start = std::chrono::steady_clock::now();
+            auto stop = start + std::chrono::seconds(RW_SECONDS);
+            std::vector<LatencyStats> pointLatency(benchmarkOptions.rwReaders);
+            std::vector<LatencyStats> rangeLatency(benchmarkOptions.rwReaders);
+            std::vector<size_t> writes(benchmarkOptions.rwWriters, 0);
+            std::vector<std::thread> threads;
+            
+            for (int t = 0; t < benchmarkOptions.rwReaders; t++) {
+                threads.emplace_back([&, t]() {
+                    std::mt19937 gen(100 + t);
+                    std::uniform_int_distribution<> percent_dist(0, 99);
+                    std::uniform_int_distribution<> index_dist(0, NUM_DOCUMENTS - 1);
+                    while (std::chrono::steady_clock::now() < stop) {
+                        bool range = percent_dist(gen) < RW_RANGE_PERCENT;
+                        int index = index_dist(gen);
+                        (range ? rangeLatency : pointLatency)[t].add(measureLatency([&]() {
+                            read(t, range, index);
+                        }));
+                    }
+                });
+            }
+            for (int t = 0; t < benchmarkOptions.rwWriters && rate > 0; t++) {
+                threads.emplace_back([&, t]() {
+                    double threadRate = static_cast<double>(rate) / benchmarkOptions.rwWriters;
+                    size_t seq = 0;
+                    while (std::chrono::steady_clock::now() < stop) {
+                        auto due = start + std::chrono::microseconds(static_cast<int64_t>(seq * 1000000.0 / threadRate));
+                        if (due > std::chrono::steady_clock::now()) {
+                            std::this_thread::sleep_until(std::min(due, stop));
+                            continue;
+                        }
+                        bool insert = seq % 2 == 0;
+                        std::string docId = insert ? interferenceDocId(rate, t, seq)
+                                                   : makeDocId("prod", (seq * 7919 + t) % NUM_DOCUMENTS);
+                        write(t, insert, docId, pool[(seq * benchmarkOptions.rwWriters + t) % pool.size()]);
+                        seq++;
+                    }
+                    writes[t] = seq;
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            
+            LatencyStats point;
+            LatencyStats range;
+            for (int t = 0; t < benchmarkOptions.rwReaders; t++) {
+                point.merge(pointLatency[t]);
+                range.merge(rangeLatency[t]);
+            }
+            size_t totalWrites = 0;
+            for (size_t count : writes) {
+                totalWrites += count;
+            }
+            recordPhaseResult("RW point read" + suffix, point);
+            recordPhaseResult("RW range read" + suffix, range);
+            recordPhaseResult("RW writes" + suffix, RW_SECONDS, totalWrites);
+        }
+    }
+    
+    // Count, sums and averages of one category as computed by the aggregation phase
+    struct CategoryAggregate {
+        std::string category;
+        size_t count = 0;
+        double priceSum = 0;
+        double stockSum = 0;
+        double priceAvg = 0;
+        double stockAvg = 0;
+    };
+    
+    // Print the per-category aggregates and check them against reference, the same figures
+    // computed another way outside the timed region
+    bool checkAggregates(const std::vector<CategoryAggregate>& aggregates, const std::vector<CategoryAggregate>& reference) {
+        auto close = [](double value, double expected) {
+            return std::fabs(value - expected) <= 1e-6 * std::max(1.0, std::fabs(expected));
+        };
+        bool matched = aggregates.size() == reference.size();
+        for (const auto& aggregate : aggregates) {
+            auto expected = std::find_if(reference.begin(), reference.end(),
+                [&](const CategoryAggregate& r) { return r.category == aggregate.category; });
+            if (expected == reference.end() || aggregate.count != expected->count ||
+                !close(aggregate.priceSum, expected->priceSum) || !close(aggregate.stockSum, expected->stockSum) ||
+                !close(aggregate.priceAvg, expected->priceAvg) || !close(aggregate.stockAvg, expected->stockAvg)) {
+                std::cerr << testName << " aggregate for " << aggregate.category << " does not match the reference" << std::endl;
+                matched = false;
+            }
+            std::cout << "    " << testName << " " << aggregate.category << ": " << aggregate.count << " products, avg price "
+                      << std::fixed << std::setprecision(2) << aggregate.priceAvg << ", avg stock " << aggregate.stockAvg << std::endl;
+        }
+        return matched;
+    }
+    
+    // Latency of CHECKPOINT_WRITES single-document writes through write(index, product), with
+    // walBytes() sampled every WAL_SAMPLE_EVERY writes to follow write-ahead log growth
+    template <typename Write, typename WalBytes>
+    void walWriteLoop(Write write, WalBytes walBytes) {
+        LatencyStats latency;
+        uint64_t peakBytes = 0;
+        for (int i = 0; i < CHECKPOINT_WRITES; i++) {
+            json product = generateRandomProduct(i);
+            latency.add(measureLatency([&]() {
+                write(i, product);
+            }));
+            if (i % WAL_SAMPLE_EVERY == 0) {
+                peakBytes = std::max(peakBytes, walBytes());
+            }
+        }
+        uint64_t finalBytes = walBytes();
+        recordPhaseResult("WAL writes", latency);
+        std::cout << "    " << testName << " WAL: peak " << std::fixed << std::setprecision(2)
+                  << std::max(peakBytes, finalBytes) / (1024.0 * 1024.0) << " MB, final "
+                  << finalBytes / (1024.0 * 1024.0) << " MB after " << CHECKPOINT_WRITES << " writes" << std::endl;
+    }
+
+    // For each COLD_START_SIZES size: load(size) fills and closes a separate store, its files
+    // are evicted from the page cache, and open() is timed reopening it, log replay included.
+    // The first COLD_START_OPS read(index) and query(index) calls are then timed cold, and
+    // again once warm, before close()
+    template <typename Load, typename WalBytes, typename Open, typename Read, typename Query, typename Close>
+    bool coldStartLoop(const std::vector<std::string>& files, Load load, WalBytes walBytes,
+                       Open open, Read read, Query query, Close close) {
+        for (int size : COLD_START_SIZES) {
+            if (!load(size)) {
+                std::cerr << testName << " cold start: failed to load " << size << " documents" << std::endl;
+                return false;
+            }
+            uint64_t walBytesLeft = walBytes();
+            uint64_t evictedBytes = 0;
+            for (const auto& file : files) {
+                evictedBytes += evictPageCache(file);
+            }
+
+            bool opened = false;
+            double openTime = measureTime([&]() {
+                opened = open();
+            });
+            if (!opened) {
+                std::cerr << testName << " cold start: failed to reopen store of " << size << " documents" << std::endl;
+                close();
+                return false;
+            }
+
+            std::mt19937 gen(13);
+            std::uniform_int_distribution<> index_dist(0, std::max(1, size) - 1);
+            std::vector<int> targets(COLD_START_OPS);
+            for (auto& target : targets) {
+                target = index_dist(gen);
+            }
+            LatencyStats coldReads, coldQueries, warmReads, warmQueries;
+            for (int index : targets) {
+                coldReads.add(measureLatency([&]() { read(index); }));
+            }
+            for (int index : targets) {
+                coldQueries.add(measureLatency([&]() { query(index); }));
+            }
+            for (int index : targets) {
+                warmReads.add(measureLatency([&]() { read(index); }));
+            }
+            for (int index : targets) {
+                warmQueries.add(measureLatency([&]() { query(index); }));
+            }
+            close();
+
+            std::string suffix = " N=" + std::to_string(size);
+            recordPhaseResult("Cold open" + suffix, openTime, 1);
+            recordPhaseResult("Cold point read" + suffix, coldReads);
+            recordPhaseResult("Cold query" + suffix, coldQueries);
+            recordPhaseResult("Warm point read" + suffix, warmReads);
+            recordPhaseResult("Warm query" + suffix, warmQueries);
+            std::cout << "    " << testName << " cold start" << suffix << ": " << std::fixed << std::setprecision(2)
+                      << evictedBytes / (1024.0 * 1024.0) << " MB evicted, " << walBytesLeft / (1024.0 * 1024.0)
+                      << " MB of log replayed, reopen " << openTime * 1000.0 << " ms" << std::endl;
+        }
+        return true;
+    }
+
+    // For each durability setting, CRASH_TRIALS times: a child re-executes this binary as the
+    // writer (runCrashWriter), reports each acknowledged write down a pipe and is SIGKILLed at
+    // a random point. recover(lastAcked) is then timed reopening the store and reading the last
+    // acknowledged product, present(index) counts the acknowledged writes that survived, and
+    // close() shuts the store again
+    template <typename WalBytes, typename Recover, typename Present, typename Close>
+    bool crashLoop(const std::vector<std::string>& settings, WalBytes walBytes,
+                   Recover recover, Present present, Close close) {
+        std::mt19937 gen(17);
+        std::uniform_int_distribution<> delay_dist(CRASH_MIN_MS, CRASH_MAX_MS);
+        for (const auto& setting : settings) {
+            LatencyStats recovery;
+            size_t acked = 0;
+            size_t survived = 0;
+            double writeSeconds = 0;
+            uint64_t peakWalBytes = 0;
+            for (int trial = 0; trial < CRASH_TRIALS; trial++) {
+                int fds[2];
+                if (pipe(fds) != 0) {
+                    std::cerr << testName << " crash: failed to create pipe" << std::endl;
+                    return false;
+                }
+                // The writer gets the current document shape and schema; everything else is default
+                std::vector<std::string> args = {
+                    "/proc/self/exe",
+                    "--crash-writer=" + testName + "," + setting + "," + std::to_string(fds[1]),
+                    "--key-format=" + benchmarkOptions.keyFormat,
+                    "--doc-size=" + benchmarkOptions.docSize,
+                    "--sqlite-schema=" + benchmarkOptions.sqliteSchema
+                };
+                if (benchmarkOptions.docNesting >= 0) args.push_back("--doc-nesting=" + std::to_string(benchmarkOptions.docNesting));
+                if (benchmarkOptions.docArrayLength >= 0) args.push_back("--doc-array-length=" + std::to_string(benchmarkOptions.docArrayLength));
+                if (benchmarkOptions.docFields >= 0) args.push_back("--doc-fields=" + std::to_string(benchmarkOptions.docFields));
+                std::vector<char*> argv;
+                for (auto& arg : args) {
+                    argv.push_back(&arg[0]);
+                }
+                argv.push_back(nullptr);
+
+                // Exec straight away rather than writing from the fork, which would inherit the
+                // parent's engine threads and locks in whatever state they were in
+                pid_t pid = fork();
+                if (pid == 0) {
+                    ::close(fds[0]);
+                    execv(argv[0], argv.data());
+                    _exit(127);
+                }
+                ::close(fds[1]);
+                if (pid < 0) {
+                    ::close(fds[0]);
+                    std::cerr << testName << " crash: fork failed" << std::endl;
+                    return false;
+                }
+
+                // Collect acknowledgements until the kill, then drain whatever the pipe still holds
+                int delayMs = delay_dist(gen);
+                auto deadline = steady_clock::now() + milliseconds(delayMs);
+                std::vector<int> ackedIndexes;
+                int index = 0;
+                auto readAck = [&]() {
+                    return ::read(fds[0], &index, sizeof(index)) == static_cast<ssize_t>(sizeof(index));
+                };
+                for (;;) {
+                    auto remaining = duration_cast<milliseconds>(deadline - steady_clock::now()).count();
+                    if (remaining <= 0) break;
+                    struct pollfd pfd = {fds[0], POLLIN, 0};
+                    if (poll(&pfd, 1, static_cast<int>(remaining)) <= 0) continue;
+                    if (!readAck()) break;
+                    ackedIndexes.push_back(index);
+                }
+                kill(pid, SIGKILL);
+                int status = 0;
+                waitpid(pid, &status, 0);
+                while (readAck()) {
+                    ackedIndexes.push_back(index);
+                }
+                ::close(fds[0]);
+                if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+                    std::cerr << testName << " crash: writer failed with status " << WEXITSTATUS(status) << std::endl;
+                    return false;
+                }
+                if (ackedIndexes.empty()) {
+                    std::cerr << testName << " crash " << setting << ": no write acknowledged within "
+                              << delayMs << " ms, trial skipped" << std::endl;
+                    continue;
+                }
+
+                writeSeconds += delayMs / 1000.0;
+                peakWalBytes = std::max(peakWalBytes, walBytes());
+                bool recovered = false;
+                recovery.add(measureLatency([&]() {
+                    recovered = recover(ackedIndexes.back());
+                }));
+                if (!recovered) {
+                    std::cerr << testName << " crash " << setting << ": failed to reopen the store" << std::endl;
+                    close();
+                    return false;
+                }
+                acked += ackedIndexes.size();
+                for (int ackedIndex : ackedIndexes) {
+                    if (present(ackedIndex)) survived++;
+                }
+                close();
+            }
+            if (recovery.count() == 0) continue;
+            // A SIGKILL loses at most the writes still in flight, so nothing surviving means the
+            // writer and this process disagree on the document ids
+            if (survived == 0) {
+                std::cerr << testName << " crash " << setting << ": none of " << acked
+                          << " acknowledged writes found after recovery" << std::endl;
+                return false;
+            }
+
+            recordPhaseResult("Recovery " + setting, recovery);
+            recordPhaseResult("Acked " + setting, writeSeconds, acked);
+            recordPhaseResult("Survived " + setting, writeSeconds, survived);
+            std::cout << "    " << testName << " crash " << setting << ": " << recovery.count() << " kills, "
+                      << acked << " writes acknowledged, " << survived << " survived (" << acked - survived
+                      << " lost), log up to " << std::fixed << std::setprecision(2)
+                      << peakWalBytes / (1024.0 * 1024.0) << " MB at recovery" << std::endl;
+        }
+        return true;
+    }
+
+    // Tell the crash phase's parent that the write of product index was acknowledged
+    static bool acknowledgeWrite(int ackFd, int index) {
+        return ::write(ackFd, &index, sizeof(index)) == static_cast<ssize_t>(sizeof(index));
+    }
+
+    // Time, harness allocations and JSON bytes of one builder phase run
+    struct BuilderRun {
+        double seconds = 0;
+        uint64_t harnessAllocations = 0;
+        size_t bytes = 0;
+    };
+
+    bool timedBuilderRun(const std::function<bool()>& run, BuilderRun& result) {
+        AllocTotals before = allocTotals();
+        bool ok = true;
+        result.seconds = measureTime([&]() { ok = run(); });
+        result.harnessAllocations = allocTotals().allocations[0] - before.allocations[0];
+        return ok;
+    }
+
+    // Default-shape products built NUM_DOCUMENTS times as nlohmann::json then dump(), and as a
+    // FlatProduct reusing one set of buffers. The shape is fixed whatever --doc-size says, so
+    // it is named in the rows recorded and the lines printed
+    void builderBuild() {
+        BuilderRun buildJson, buildFlat;
+        FlatProduct flat;
+        timedBuilderRun([&]() {
+            for (int i = 0; i < NUM_DOCUMENTS; i++) {
+                buildJson.bytes += generateRandomProduct(i, BUILDER_SHAPE).dump().size();
+            }
+            return true;
+        }, buildJson);
+        timedBuilderRun([&]() {
+            for (int i = 0; i < NUM_DOCUMENTS; i++) {
+                buildFlatProduct(i, flat);
+                buildFlat.bytes += flat.json.size();
+            }
+            return true;
+        }, buildFlat);
+
+        recordPhaseResult("Build json (" + BUILDER_SHAPE + ")", buildJson.seconds, NUM_DOCUMENTS, buildJson.bytes);
+        recordPhaseResult("Build flat (" + BUILDER_SHAPE + ")", buildFlat.seconds, NUM_DOCUMENTS, buildFlat.bytes);
+        double gain = buildFlat.seconds > 0 ? (buildJson.seconds / buildFlat.seconds - 1.0) * 100.0 : 0.0;
+        std::cout << "    " << testName << " builder (" << BUILDER_SHAPE << " shape): flat build " << std::fixed
+                  << std::setprecision(1) << gain << "% faster" << std::endl;
+        if (countingAllocations) {
+            std::cout << "    " << testName << " builder: harness allocations per document, build "
+                      << std::setprecision(2) << buildJson.harnessAllocations / double(NUM_DOCUMENTS) << " -> "
+                      << buildFlat.harnessAllocations / double(NUM_DOCUMENTS) << std::endl;
+        }
+    }
+
+    // builderBuild(), then both sets inserted into a fresh store each, begin() and end()
+    // bracketing every insert run. insertJson(index, docId, jsonStr, product) and
+    // insertFlat(index, flat) return false on failure
+    template <typename Begin, typename InsertJson, typename InsertFlat, typename End>
+    bool builderLoop(Begin begin, InsertJson insertJson, InsertFlat insertFlat, End end) {
+        builderBuild();
+
+        BuilderRun insertJsonRun, insertFlatRun;
+        FlatProduct flat;
+        bool ok = begin() && timedBuilderRun([&]() {
+            for (int i = 0; i < NUM_DOCUMENTS; i++) {
+                json product = generateRandomProduct(i, BUILDER_SHAPE);
+                if (!insertJson(i, makeDocId("prod", i), product.dump(), product)) return false;
+            }
+            return true;
+        }, insertJsonRun);
+        ok = end() && ok;
+        ok = ok && begin() && timedBuilderRun([&]() {
+            for (int i = 0; i < NUM_DOCUMENTS; i++) {
+                buildFlatProduct(i, flat);
+                if (!insertFlat(i, flat)) return false;
+            }
+            return true;
+        }, insertFlatRun);
+        ok = end() && ok;
+        if (!ok) {
+            std::cerr << testName << " builder: insert failed" << std::endl;
+            return false;
+        }
+
+        recordPhaseResult("Insert json (" + BUILDER_SHAPE + ")", insertJsonRun.seconds, NUM_DOCUMENTS);
+        recordPhaseResult("Insert flat (" + BUILDER_SHAPE + ")", insertFlatRun.seconds, NUM_DOCUMENTS);
+        double gain = insertFlatRun.seconds > 0 ? (insertJsonRun.seconds / insertFlatRun.seconds - 1.0) * 100.0 : 0.0;
+        std::cout << "    " << testName << " builder (" << BUILDER_SHAPE << " shape): insert throughput recovered "
+                  << std::fixed << std::setprecision(1) << gain << "%" << std::endl;
+        if (countingAllocations) {
+            std::cout << "    " << testName << " builder: harness allocations per document, insert "
+                      << std::setprecision(2) << insertJsonRun.harnessAllocations / double(NUM_DOCUMENTS) << " -> "
+                      << insertFlatRun.harnessAllocations / double(NUM_DOCUMENTS) << std::endl;
+        }
+        return true;
+    }
+
+    // Cores the parallel phase's workers ran on, sampled once per operation, and the
+    // involuntary context switches they took
+    struct CpuPlacement {
+        std::vector<int> cpus;
+        int lastCpu = -1;
+        int migrations = 0;
+        long switchesAtStart = 0;
+        long involuntarySwitches = 0;
+
+        void start() {
+            struct rusage usage;
+            getrusage(RUSAGE_THREAD, &usage);
+            switchesAtStart = usage.ru_nivcsw;
+            sample();
+        }
+
+        void sample() {
+            int cpu = sched_getcpu();
+            if (cpu == lastCpu) return;
+            if (lastCpu >= 0) migrations++;
+            if (std::find(cpus.begin(), cpus.end(), cpu) == cpus.end()) cpus.push_back(cpu);
+            lastCpu = cpu;
+        }
+
+        void finish() {
+            struct rusage usage;
+            getrusage(RUSAGE_THREAD, &usage);
+            involuntarySwitches = usage.ru_nivcsw - switchesAtStart;
+        }
+    };
+
+    // With --pin-threads=on, pin the calling worker to one of the cores the process may use,
+    // round-robin by worker number
+    static void pinWorker(int worker) {
+        if (!benchmarkOptions.pinThreads) return;
+        std::vector<int> allowed = allowedCpus();
+        if (allowed.empty()) return;
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(allowed[worker % allowed.size()], &mask);
+        sched_setaffinity(0, sizeof(mask), &mask);
+    }
+
+    void reportPlacement(const std::vector<CpuPlacement>& placements, double seconds) {
+        int migrations = 0;
+        long switches = 0;
+        std::cout << "    " << testName << " parallel placement:";
+        for (size_t t = 0; t < placements.size(); t++) {
+            std::cout << " t" << t << "=cpu";
+            for (size_t c = 0; c < placements[t].cpus.size(); c++) {
+                std::cout << (c ? "," : "") << placements[t].cpus[c];
+            }
+            migrations += placements[t].migrations;
+            switches += placements[t].involuntarySwitches;
+        }
+        std::cout << "; " << migrations << " migrations, " << switches << " involuntary switches" << std::endl;
+        recordPhaseResult("Parallel migrations", seconds, migrations);
+        recordPhaseResult("Parallel preemptions", seconds, switches);
+    }
+
+    // Run an engine call with the calling thread marked as inside the engine, so
+    // --alloc-stats counts its allocations as the engine's
+    template <typename Call>
+    static auto inEngine(Call call) -> decltype(call()) {
+        EngineScope scope;
+        return call();
+    }
+
+    // Id of the document inserted as write seq of writer thread at a given write rate
+    static std::string interferenceDocId(int rate, int thread, size_t seq) {
+        return makeDocId("rw" + std::to_string(rate) + "_" + std::to_string(thread) + "_", seq);
+    }
+    
+    // Deleted product indexes whose reads are timed by the tombstone phase
+    static std::vector<int> deletedProbeTargets(int deleted) {
+        std::mt19937 gen(11);
+        std::uniform_int_distribution<> index_dist(0, std::max(1, deleted) - 1);
+        std::vector<int> targets(NUM_QUERIES);
+        for (auto& target : targets) {
+            target = index_dist(gen);
+        }
+        return targets;
+    }
+    
+    // Product of size class docSize with a tags[] array for $push to append to
+    json generatePartialUpdateProduct(int index, const std::string& docSize) {
+        json product = generateRandomProduct(index, docSize);
+        product["tags"] = json::array({"initial"});
+        return product;
+    }
+    
+    // Indexes of the products updated by the partial update phase, the same for every engine
+    static std::vector<int> partialUpdateTargets() {
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<> index_dist(0, std::max(1, PARTIAL_UPDATE_DOCUMENTS) - 1);
+        std::vector<int> targets(PARTIAL_UPDATE_OPS);
+        for (auto& target : targets) {
+            target = index_dist(gen);
+        }
+        return targets;
+    }
+    
+    // Client-side equivalent of partial update r with operator op
+    static void applyPartialUpdate(json& product, const std::string& op, int r) {
+        if (op == "$set") {
+            product["price"] = partialUpdatePrice(r);
+        } else if (op == "$inc") {
+            product["stock"] = product.value("stock", 0) + 1;
+        } else if (op == "$push") {
+            product["tags"].push_back("tag" + std::to_string(r));
+        } else {
+            product["price"] = partialUpdatePrice(r);
+            product["stock"] = r % 500;
+        }
+    }
+    
+    static double partialUpdatePrice(int r) {
+        return 10.0 + (r % 1000) + 0.99;
+    }
+    
+    // Helper method to generate random product data of size class docSize (see --doc-size)
+    json generateRandomProduct(int index, const std::string& docSize = benchmarkOptions.docSize) {
+        // Each thread draws from its own generator; the parallel phase builds products concurrently
+        static thread_local std::mt19937 gen(std::random_device{}());
+        static thread_local std::uniform_real_distribution<> price_dist(10.0, 2000.0);
+        static thread_local std::uniform_int_distribution<> stock_dist(0, 500);
+        static thread_local std::uniform_real_distribution<> rating_dist(1.0, 5.0);
+        static thread_local std::uniform_int_distribution<> category_dist(0, 3);
+        
+        const std::vector<std::string>& categories = CATEGORIES;
+        static const std::vector<std::string> brands = {"TechMaster", "ReadBooks", "FoodDelight", "FashionStyle"};
+        
+        int category_idx = category_dist(gen);
+        double price = std::round(price_dist(gen) * 100.0) / 100.0;
+        int stock = stock_dist(gen);
+        double rating = std::round(rating_dist(gen) * 10.0) / 10.0;
+        
+        json product = {
+            {"id", makeDocId("prod", index)},
+            {"name", "Product " + std::to_string(index)},
+            {"price", price},
+            {"stock", stock},
+            {"category", categories[category_idx]},
+            {"brand", brands[category_idx]},
+            {"rating", rating},
+            {"available", (stock > 0)},
+            {"created_at", getCurrentTimeString()}
+        };
+        
+        // Add category-specific attributes
         switch (category_idx) {
             case 0: // Electronics
                 product["specs"] = {
@@ -142,202 +1909,1732 @@ protected:
                 break;
         }
         
-        return product;
+        // Pad the product out to the selected document shape
+        addFiller(product, index, gen, docSize);
+        
+        return product;
+    }
+    
+    // Shape used for the next document of size class docSize, drawn per document for "mixed"
+    DocumentShape selectShape(std::mt19937& gen, const std::string& docSize) {
+        DocumentShape shape = DOCUMENT_SHAPES[0];
+        if (docSize == "mixed") {
+            std::uniform_int_distribution<> percent_dist(0, 99);
+            int draw = percent_dist(gen);
+            for (size_t i = 0; i < DOCUMENT_SHAPES.size(); i++) {
+                draw -= MIXED_SHAPE_WEIGHTS[i];
+                if (draw < 0) {
+                    shape = DOCUMENT_SHAPES[i];
+                    break;
+                }
+            }
+        } else {
+            for (const auto& candidate : DOCUMENT_SHAPES) {
+                if (candidate.name == docSize) {
+                    shape = candidate;
+                }
+            }
+        }
+        
+        if (shape.maxBytes > 0) {
+            if (benchmarkOptions.docNesting >= 0) shape.nestingDepth = benchmarkOptions.docNesting;
+            if (benchmarkOptions.docArrayLength >= 0) shape.arrayLength = benchmarkOptions.docArrayLength;
+            if (benchmarkOptions.docFields >= 0) shape.fieldCount = benchmarkOptions.docFields;
+        }
+        return shape;
+    }
+    
+    // Random alphanumeric text of length bytes, cut from a shared pool so large
+    // documents stay cheap to build and do not compress trivially
+    static std::string fillerText(std::mt19937& gen, size_t length) {
+        static const std::string pool = []() {
+            const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+            std::mt19937 poolGen(42);
+            std::string text(1024 * 1024, ' ');
+            for (auto& c : text) {
+                c = alphabet[poolGen() % (sizeof(alphabet) - 1)];
+            }
+            return text;
+        }();
+        length = std::min(length, pool.size());
+        std::uniform_int_distribution<size_t> offset_dist(0, pool.size() - length);
+        return pool.substr(offset_dist(gen), length);
+    }
+    
+    // Add an attributes object and a nested items[] array sized to the selected shape
+    void addFiller(json& product, int index, std::mt19937& gen, const std::string& docSize) {
+        DocumentShape shape = selectShape(gen, docSize);
+        if (shape.maxBytes == 0) return;
+        
+        std::uniform_int_distribution<> size_dist(shape.minBytes, shape.maxBytes);
+        int target = size_dist(gen);
+        int depth = std::max(1, shape.nestingDepth);
+        int strings = std::max(1, shape.fieldCount + shape.arrayLength * depth);
+        // Roughly 24 bytes of keys and punctuation surround every filler string
+        size_t stringBytes = std::max(1, (target - BASE_PRODUCT_BYTES) / strings - 24);
+        
+        json attributes = json::object();
+        for (int f = 0; f < shape.fieldCount; f++) {
+            attributes["attr" + std::to_string(f)] = fillerText(gen, stringBytes);
+        }
+        product["attributes"] = attributes;
+        
+        json items = json::array();
+        for (int a = 0; a < shape.arrayLength; a++) {
+            json item = {{"seq", index * shape.arrayLength + a}, {"label", fillerText(gen, stringBytes)}};
+            for (int level = 1; level < depth; level++) {
+                item = {{"seq", level}, {"label", fillerText(gen, stringBytes)}, {"child", item}};
+            }
+            items.push_back(item);
+        }
+        product["items"] = items;
+    }
+    
+    // Get current time as formatted string
+    std::string getCurrentTimeString() {
+        return cachedTimeString();
+    }
+    
+    // Current local time as "YYYY-MM-DD HH:MM:SS", formatted at most once per second per thread
+    static const char* cachedTimeString() {
+        static thread_local std::time_t formattedSecond = -1;
+        static thread_local char formatted[20];
+        std::time_t now = std::time(nullptr);
+        if (now != formattedSecond) {
+            std::tm tm_info;
+            localtime_r(&now, &tm_info);
+            std::strftime(formatted, sizeof(formatted), "%Y-%m-%d %H:%M:%S", &tm_info);
+            formattedSecond = now;
+        }
+        return formatted;
+    }
+    
+    // Product serialized straight into reused buffers, with the fields SQLite's shadow columns
+    // take kept alongside. Clearing a std::string keeps its capacity, so once the buffers have
+    // grown to a full document, building the next one allocates nothing
+    struct FlatProduct {
+        std::string docId;
+        std::string json;
+        const char* category = nullptr;
+        double price = 0;
+        int stock = 0;
+        double rating = 0;
+    };
+    
+    // Build product index into out: the default-shape fields of generateRandomProduct,
+    // written as JSON text without going through nlohmann::json
+    void buildFlatProduct(int index, FlatProduct& out) {
+        static thread_local std::mt19937 gen(std::random_device{}());
+        static thread_local std::uniform_real_distribution<> price_dist(10.0, 2000.0);
+        static thread_local std::uniform_int_distribution<> stock_dist(0, 500);
+        static thread_local std::uniform_real_distribution<> rating_dist(1.0, 5.0);
+        static thread_local std::uniform_int_distribution<> category_dist(0, 3);
+        static const char* const brands[] = {"TechMaster", "ReadBooks", "FoodDelight", "FashionStyle"};
+        static const char* const sizes[] = {"XS", "S", "M", "L", "XL", "XXL"};
+        static const char* const colors[] = {"Red", "Blue", "Green", "Black", "White", "Yellow", "Purple"};
+        static const char* const materials[] = {"Cotton", "Polyester", "Wool", "Silk"};
+        
+        int category_idx = category_dist(gen);
+        out.category = CATEGORIES[category_idx].c_str();
+        out.price = std::round(price_dist(gen) * 100.0) / 100.0;
+        out.stock = stock_dist(gen);
+        out.rating = std::round(rating_dist(gen) * 10.0) / 10.0;
+        makeDocId("prod", index, out.docId);
+        
+        char buffer[512];
+        int length = std::snprintf(buffer, sizeof(buffer),
+            "{\"id\":\"%s\",\"name\":\"Product %d\",\"price\":%.2f,\"stock\":%d,\"category\":\"%s\","
+            "\"brand\":\"%s\",\"rating\":%.1f,\"available\":%s,\"created_at\":\"%s\"",
+            out.docId.c_str(), index, out.price, out.stock, out.category, brands[category_idx], out.rating,
+            out.stock > 0 ? "true" : "false", cachedTimeString());
+        out.json.clear();
+        out.json.append(buffer, std::min<size_t>(length, sizeof(buffer) - 1));
+        
+        switch (category_idx) {
+            case 0:
+                length = std::snprintf(buffer, sizeof(buffer),
+                    ",\"specs\":{\"processor\":\"i%d\",\"ram\":\"%dGB\",\"storage\":\"%dGB\"}",
+                    5 + (index % 5), 4 * (1 + (index % 4)), 128 * (1 + (index % 8)));
+                break;
+            case 1:
+                length = std::snprintf(buffer, sizeof(buffer),
+                    ",\"author\":\"Author %d\",\"pages\":%d,\"publisher\":\"Publisher %d\"",
+                    1 + (index % 20), 100 + (index % 500), 1 + (index % 10));
+                break;
+            case 2:
+                length = std::snprintf(buffer, sizeof(buffer),
+                    ",\"expiry_date\":\"2025-%d-%d\",\"weight\":\"%dg\",\"organic\":%s",
+                    1 + (index % 12), 1 + (index % 28), (index % 10) * 100, index % 2 == 0 ? "true" : "false");
+                break;
+            default:
+                length = std::snprintf(buffer, sizeof(buffer),
+                    ",\"size\":\"%s\",\"color\":\"%s\",\"material\":\"%s\"",
+                    sizes[index % 6], colors[index % 7], materials[index % 4]);
+                break;
+        }
+        out.json.append(buffer, std::min<size_t>(length, sizeof(buffer) - 1));
+        out.json += '}';
+    }
+    
+    // Price bounds of scan partition t of n. Prices carry two decimals, so half-cent
+    // boundaries never coincide with a stored price and no product is missed.
+    static void scanPartition(int t, int n, double& low, double& high) {
+        const double minPrice = 10.0, maxPrice = 2000.0;
+        double width = (maxPrice - minPrice) / n;
+        low = t == 0 ? 0.0 : std::floor((minPrice + t * width) * 100.0) / 100.0 + 0.005;
+        high = t == n - 1 ? std::numeric_limits<double>::max()
+                          : std::floor((minPrice + (t + 1) * width) * 100.0) / 100.0 + 0.005;
+    }
+    
+    // Write count generated products to path as JSON lines and return the bytes written
+    uint64_t writeImportFile(const std::string& path, int count) {
+        std::ofstream out(path.c_str(), std::ios::trunc);
+        for (int i = 0; i < count; i++) {
+            out << generateRandomProduct(i).dump() << '\n';
+        }
+        out.close();
+        return pathSizeBytes(path);
+    }
+    
+    // Timer function for benchmarking
+    template<typename Func>
+    double measureTime(Func&& func) {
+        auto start = high_resolution_clock::now();
+        func();
+        auto end = high_resolution_clock::now();
+        return duration_cast<microseconds>(end - start).count() / 1000000.0;
+    }
+    
+    // Latency of a single operation in microseconds
+    template<typename Func>
+    double measureLatency(Func&& func) {
+        auto start = high_resolution_clock::now();
+        func();
+        auto end = high_resolution_clock::now();
+        return duration_cast<nanoseconds>(end - start).count() / 1000.0;
+    }
+};
+
+// AnuDB test implementation
+class AnuDBTest : public BenchmarkTest {
+public:
+    AnuDBTest() : BenchmarkTest("AnuDB") {}
+    
+    bool setup() override {
+        // Remove any existing database so every run starts from an empty store
+        removePath(DB_PATH_ANUDB);
+        
+        // AnuDB builds its RocksDB options internally and takes no cache or write
+        // buffer sizes, so a --cache-mb budget can only be reported, not applied
+        if (benchmarkOptions.cacheMb > 0) {
+            std::cout << "  AnuDB: --cache-mb not configurable, RocksDB defaults in use" << std::endl;
+        }
+        if (benchmarkOptions.mmap) {
+            std::cout << "  AnuDB: --mmap not configurable, RocksDB reads use pread" << std::endl;
+        }
+        if (benchmarkOptions.storageProfile != 0) {
+            std::cout << "  AnuDB: --storage-profile not applied, its RocksDB Env cannot be wrapped" << std::endl;
+        }
+
+        db = inEngine([&]() { return std::make_unique<anudb::Database>(DB_PATH_ANUDB); });
+        auto status = inEngine([&]() { return db->open(); });
+        if (!status.ok()) {
+            std::cerr << "Failed to open AnuDB database: " << status.message() << std::endl;
+            return false;
+        }
+        
+        // Create collection
+        status = inEngine([&]() { return db->createCollection(COLLECTION_NAME); });
+        if (!status.ok() && status.message().find("already exists") == std::string::npos) {
+            std::cerr << "Failed to create collection: " << status.message() << std::endl;
+            return false;
+        }
+        
+        collection = inEngine([&]() { return db->getCollection(COLLECTION_NAME); });
+        if (!collection) {
+            std::cerr << "Failed to get collection." << std::endl;
+            return false;
+        }
+        
+        // Create indexes
+        for (const auto& field : INDEX_FIELDS) {
+            status = inEngine([&]() { return collection->createIndex(field); });
+            if (!status.ok() && status.message().find("already exists") == std::string::npos) {
+                std::cerr << "Failed to create index on " << field << ": " << status.message() << std::endl;
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    bool cleanup() override {
+        if (!db) return false;
+        auto status = inEngine([&]() { return db->close(); });
+        return status.ok();
+    }
+    
+    bool runInsertTest() override {
+        if (!collection) return false;
+        
+        int successCount = 0;
+        results.insertTime = measureTime([&]() {
+            for (int i = 0; i < NUM_DOCUMENTS; i++) {
+                json productData = generateRandomProduct(i);
+                std::string docId = makeDocId("prod", i);
+                
+                anudb::Document doc(docId, productData);
+                auto status = inEngine([&]() { return collection->createDocument(doc); });
+                
+                if (status.ok()) {
+                    successCount++;
+                }
+            }
+        });
+        
+        results.insertOps = successCount;
+        results.insertBytes = storedBytes("prod", NUM_DOCUMENTS);
+        return true;
+    }
+    
+    bool runQueryTest() override {
+        if (!collection) return false;
+        
+        int successCount = 0;
+        std::vector<json> queries = {
+            // Query by category
+            {{"$eq", {{"category", "Electronics"}}}},
+            {{"$eq", {{"category", "Books"}}}},
+            {{"$eq", {{"category", "Food"}}}},
+            {{"$eq", {{"category", "Clothing"}}}},
+            
+            // Query by price range
+            {{"$gt", {{"price", 500.0}}}},
+            {{"$lt", {{"price", 100.0}}}},
+            {{"$and", {
+                {{"$gt", {{"price", 100.0}}}},
+                {{"$lt", {{"price", 500.0}}}}
+            }}},
+            
+            // Query by rating
+            {{"$gt", {{"rating", 4.0}}}},
+            
+            // Query by availability
+            {{"$eq", {{"available", true}}}},
+            
+            // Combined queries
+            {{"$and", {
+                {{"$eq", {{"category", "Electronics"}}}},
+                {{"$gt", {{"price", 1000.0}}}}
+            }}}
+        };
+        
+        results.queryTime = measureTime([&]() {
+            for (int i = 0; i < NUM_QUERIES; i++) {
+                const json& query = queries[i % queries.size()];
+                std::vector<std::string> docIds = inEngine([&]() { return collection->findDocument(query); });
+                successCount += docIds.size() > 0 ? 1 : 0;
+            }
+        });
+        
+        results.queryOps = NUM_QUERIES;
+        return true;
+    }
+    
+    bool runUpdateTest() override {
+        if (!collection) return false;
+        
+        int successCount = 0;
+        results.updateTime = measureTime([&]() {
+            for (int i = 0; i < NUM_DOCUMENTS / 2; i++) {
+                std::string docId = makeDocId("prod", i);
+                
+                // Generate update data
+                json updateData = {
+                    {"$set", {
+                        {"price", 100.0 + (i % 10) * 50.0},
+                        {"stock", 10 + (i % 20)},
+                        {"updated_at", getCurrentTimeString()}
+                    }}
+                };
+                
+                auto status = inEngine([&]() { return collection->updateDocument(docId, updateData); });
+                if (status.ok()) {
+                    successCount++;
+                }
+            }
+        });
+        
+        results.updateOps = successCount;
+        results.updateBytes = storedBytes("prod", NUM_DOCUMENTS / 2);
+        return true;
+    }
+    
+    bool runDeleteTest() override {
+        if (!collection) return false;
+        
+        int successCount = 0;
+        results.deleteTime = measureTime([&]() {
+            for (int i = 0; i < NUM_DOCUMENTS / 4; i++) {
+                std::string docId = makeDocId("prod", i * 3);  // Delete every third document
+                
+                auto status = inEngine([&]() { return collection->deleteDocument(docId); });
+                if (status.ok()) {
+                    successCount++;
+                }
+            }
+        });
+        
+        results.deleteOps = successCount;
+        return true;
+    }
+    
+    bool runParallelTest() override {
+        if (!collection) return false;
+        
+        std::vector<std::thread> threads;
+        std::vector<CpuPlacement> placements(NUM_THREADS);
+        std::atomic<int> successCount(0);
+        std::mutex mtx;
+        
+        // Create a barrier to synchronize thread start
+        std::atomic<int> barrier(0);
+        
+        auto start = high_resolution_clock::now();
+        
+        // Spawn threads
+        for (int t = 0; t < NUM_THREADS; t++) {
+            threads.emplace_back([&, t]() {
+                // Wait until all threads are ready
+                barrier.fetch_add(1);
+                while (barrier.load() < NUM_THREADS) {
+                    std::this_thread::yield();
+                }
+                pinWorker(t);
+                CpuPlacement& placement = placements[t];
+                placement.start();
+                
+                int threadSuccessCount = 0;
+                int docsPerThread = NUM_DOCUMENTS / NUM_THREADS;
+                int startIdx = t * docsPerThread;
+                int endIdx = startIdx + docsPerThread;
+                
+                // Each thread performs a mix of operations
+                for (int i = startIdx; i < endIdx; i++) {
+                    std::string docId = makeDocId("parallel_prod", i);
+                    
+                    // Insert
+                    json productData = generateRandomProduct(i + 10000);  // Offset to avoid conflicts
+                    anudb::Document doc(docId, productData);
+                    auto status = inEngine([&]() { return collection->createDocument(doc); });
+                    if (status.ok()) {
+                        threadSuccessCount++;
+                    }
+                    
+                    // Query
+                    if (i % 5 == 0) {
+                        json query = {{"$eq", {{"category", productData["category"].get<std::string>()}}}};
+			std::vector<std::string> docIds;
+                        docIds = inEngine([&]() { return collection->findDocument(query); });
+			for (const std::string& docId : docIds) {
+			    anudb::Document doc;
+			    inEngine([&]() { return collection->readDocument(docId, doc); });
+			}
+                    }
+                    
+                    // Update
+                    if (i % 3 == 0) {
+                        json updateData = {
+                            {"$set", {
+                                {"price", (double)productData["price"] * 1.1},
+                                {"stock", i % 100},
+                                {"updated_at", getCurrentTimeString()}
+                            }}
+                        };
+                        inEngine([&]() { return collection->updateDocument(docId, updateData); });
+                    }
+                    
+                    // Delete
+                    if (i % 7 == 0) {
+                        inEngine([&]() { return collection->deleteDocument(docId); });
+                    }
+                    placement.sample();
+                }
+                placement.finish();
+                
+                successCount.fetch_add(threadSuccessCount);
+            });
+        }
+        
+        // Join all threads
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        
+        auto end = high_resolution_clock::now();
+        results.parallelTime = duration_cast<milliseconds>(end - start).count() / 1000.0;
+        results.parallelOps = successCount.load();
+        // Parallel documents are updated and deleted as they go, so estimate
+        // their size from the insert phase instead of reading them back
+        if (results.insertOps > 0) {
+            results.parallelBytes = results.parallelOps * (results.insertBytes / results.insertOps);
+        }
+        reportPlacement(placements, results.parallelTime);
+        
+        return true;
+    }
+    
+    bool runIndexTest() override {
+        if (!db) return false;
+        
+        const std::string benchCollection = COLLECTION_NAME + "_index_bench";
+        
+        // Insert throughput with 0..N secondary indexes maintained on every write
+        for (size_t indexCount = 0; indexCount <= INDEX_FIELDS.size(); indexCount++) {
+            anudb::Collection* target = createScratchCollection(benchCollection);
+            if (!target) return false;
+            
+            for (size_t f = 0; f < indexCount; f++) {
+                auto status = inEngine([&]() { return target->createIndex(INDEX_FIELDS[f]); });
+                if (!status.ok()) {
+                    std::cerr << "Failed to create index on " << INDEX_FIELDS[f] << ": " << status.message() << std::endl;
+                    return false;
+                }
+            }
+            
+            int successCount = 0;
+            double time = measureTime([&]() {
+                successCount = insertProducts(target, NUM_DOCUMENTS);
+            });
+            recordPhaseResult("Insert " + std::to_string(indexCount) + " idx", time, successCount);
+            
+            inEngine([&]() { return db->dropCollection(benchCollection); });
+        }
+        
+        // Bulk load first, then build each index over the loaded collection
+        anudb::Collection* target = createScratchCollection(benchCollection);
+        if (!target) return false;
+        
+        int loaded = 0;
+        double loadTime = measureTime([&]() {
+            loaded = insertProducts(target, benchmarkOptions.indexBuildDocuments);
+        });
+        recordPhaseResult("Bulk load 0 idx", loadTime, loaded);
+        
+        for (const auto& field : INDEX_FIELDS) {
+            bool built = false;
+            double time = measureTime([&]() {
+                built = inEngine([&]() { return target->createIndex(field); }).ok();
+            });
+            if (!built) {
+                std::cerr << "Failed to build index on " << field << std::endl;
+                continue;
+            }
+            recordPhaseResult("Build idx " + field, time, loaded);
+        }
+        
+        inEngine([&]() { return db->dropCollection(benchCollection); });
+        return true;
+    }
+    
+    bool runTopKTest() override {
+        if (!collection) return false;
+        
+        // findDocument has no limit; use $orderBy when it is honoured, else sort harness-side
+        bool nativeOrdering = supportsOrderBy("price");
+        std::cout << "    AnuDB ordering: " << (nativeOrdering ? "$orderBy" : "harness-side sort") << std::endl;
+        
+        for (const std::string field : {"price", "rating"}) {
+            for (int k : TOPK_SIZES) {
+                LatencyStats latency;
+                for (int r = 0; r < TOPK_REPEATS; r++) {
+                    latency.add(measureLatency([&]() {
+                        orderedProducts(field, true, nativeOrdering, 0, k);
+                    }));
+                }
+                recordPhaseResult("TopK " + field + " K=" + std::to_string(k), latency);
+            }
+        }
+        
+        // OFFSET-style pagination: every page is ordered from the start of the result
+        for (int page : PAGE_DEPTHS) {
+            LatencyStats latency;
+            for (int r = 0; r < TOPK_REPEATS; r++) {
+                latency.add(measureLatency([&]() {
+                    orderedProducts("price", false, nativeOrdering, (page - 1) * PAGE_SIZE, PAGE_SIZE);
+                }));
+            }
+            recordPhaseResult("Offset page " + std::to_string(page), latency);
+        }
+        
+        // Keyset pagination: each page is a range query starting after the previous page's last key
+        std::vector<LatencyStats> keysetLatency(PAGE_DEPTHS.size());
+        for (int walk = 0; walk < KEYSET_WALKS; walk++) {
+            RankedProduct last = {std::numeric_limits<double>::lowest(), "", json()};
+            for (int page = 1; page <= PAGE_DEPTHS.back(); page++) {
+                std::vector<RankedProduct> rows;
+                double micros = measureLatency([&]() {
+                    rows = keysetPage("price", last, PAGE_SIZE);
+                });
+                auto depth = std::find(PAGE_DEPTHS.begin(), PAGE_DEPTHS.end(), page);
+                if (depth != PAGE_DEPTHS.end()) {
+                    keysetLatency[depth - PAGE_DEPTHS.begin()].add(micros);
+                }
+                if (rows.empty()) break;
+                last = rows.back();
+            }
+        }
+        for (size_t d = 0; d < PAGE_DEPTHS.size(); d++) {
+            recordPhaseResult("Keyset page " + std::to_string(PAGE_DEPTHS[d]), keysetLatency[d]);
+        }
+        
+        return true;
+    }
+    
+    bool runAggregationTest() override {
+        if (!collection) return false;
+        
+        // AnuDB has no aggregation: fetch each category's documents, copy the
+        // aggregated fields into columns and reduce the columns with sumColumn()
+        LatencyStats fetchLatency, extractLatency, reduceLatency, totalLatency;
+        std::vector<CategoryAggregate> aggregates, reference;
+        for (int r = 0; r < AGGREGATION_REPEATS; r++) {
+            std::vector<std::vector<anudb::Document>> groups(CATEGORIES.size());
+            std::vector<std::vector<double>> priceColumns(CATEGORIES.size());
+            std::vector<std::vector<double>> stockColumns(CATEGORIES.size());
+            std::vector<double> priceSums(CATEGORIES.size()), stockSums(CATEGORIES.size());
+            
+            double fetchMicros = measureLatency([&]() {
+                for (size_t c = 0; c < CATEGORIES.size(); c++) {
+                    json query = {{"$eq", {{"category", CATEGORIES[c]}}}};
+                    std::vector<std::string> docIds = inEngine([&]() { return collection->findDocument(query); });
+                    groups[c].resize(docIds.size());
+                    for (size_t d = 0; d < docIds.size(); d++) {
+                        inEngine([&]() { return collection->readDocument(docIds[d], groups[c][d]); });
+                    }
+                }
+            });
+            
+            double extractMicros = measureLatency([&]() {
+                for (size_t c = 0; c < CATEGORIES.size(); c++) {
+                    priceColumns[c].reserve(groups[c].size());
+                    stockColumns[c].reserve(groups[c].size());
+                    for (auto& doc : groups[c]) {
+                        const json& data = doc.data();
+                        if (data.is_object()) {
+                            priceColumns[c].push_back(data.value("price", 0.0));
+                            stockColumns[c].push_back(data.value("stock", 0));
+                        }
+                    }
+                }
+            });
+            
+            double reduceMicros = measureLatency([&]() {
+                for (size_t c = 0; c < CATEGORIES.size(); c++) {
+                    priceSums[c] = sumColumn(priceColumns[c].data(), priceColumns[c].size());
+                    stockSums[c] = sumColumn(stockColumns[c].data(), stockColumns[c].size());
+                }
+            });
+            
+            fetchLatency.add(fetchMicros);
+            extractLatency.add(extractMicros);
+            reduceLatency.add(reduceMicros);
+            totalLatency.add(fetchMicros + extractMicros + reduceMicros);
+            
+            // Averages from the reduced sums; the reference sums the fetched documents one by one
+            aggregates.assign(CATEGORIES.size(), CategoryAggregate());
+            reference.assign(CATEGORIES.size(), CategoryAggregate());
+            for (size_t c = 0; c < CATEGORIES.size(); c++) {
+                CategoryAggregate& aggregate = aggregates[c];
+                aggregate.category = CATEGORIES[c];
+                aggregate.count = priceColumns[c].size();
+                aggregate.priceSum = priceSums[c];
+                aggregate.stockSum = stockSums[c];
+                aggregate.priceAvg = aggregate.count > 0 ? aggregate.priceSum / aggregate.count : 0;
+                aggregate.stockAvg = aggregate.count > 0 ? aggregate.stockSum / aggregate.count : 0;
+                
+                CategoryAggregate& expected = reference[c];
+                expected.category = CATEGORIES[c];
+                for (auto& doc : groups[c]) {
+                    const json& data = doc.data();
+                    if (!data.is_object()) continue;
+                    expected.count++;
+                    expected.priceSum += data.value("price", 0.0);
+                    expected.stockSum += data.value("stock", 0);
+                }
+                expected.priceAvg = expected.count > 0 ? expected.priceSum / expected.count : 0;
+                expected.stockAvg = expected.count > 0 ? expected.stockSum / expected.count : 0;
+            }
+        }
+        
+        recordPhaseResult("Aggregate fetch", fetchLatency);
+        recordPhaseResult("Aggregate extract", extractLatency);
+        recordPhaseResult("Aggregate reduce", reduceLatency);
+        recordPhaseResult("Aggregate total", totalLatency);
+        return checkAggregates(aggregates, reference);
+    }
+    
+    bool runScanTest() override {
+        if (!collection) return false;
+        
+        // Walk every document through readAllDocuments; it has no cursor, so the
+        // whole collection is materialized at once rather than streamed
+        std::vector<anudb::Document> docs;
+        double scanTime = measureTime([&]() {
+            inEngine([&]() { return collection->readAllDocuments(docs, std::numeric_limits<uint64_t>::max()); });
+        });
+        uint64_t scanBytes = 0;
+        for (auto& doc : docs) {
+            scanBytes += doc.data().dump().size();
+        }
+        size_t scanned = docs.size();
+        std::vector<anudb::Document>().swap(docs);
+        recordPhaseResult("Scan all", scanTime, scanned, scanBytes);
+        
+        // Export through the collection's JSON export facility
+        removePath(EXPORT_PATH);
+        mkdir(EXPORT_PATH.c_str(), 0755);
+        bool exported = false;
+        double exportTime = measureTime([&]() {
+            exported = inEngine([&]() { return collection->exportAllToJsonAsync(EXPORT_PATH); }).ok();
+            inEngine([&]() { return collection->waitForExportOperation(); });
+        });
+        if (exported) {
+            recordPhaseResult("Export JSON", exportTime, scanned, pathSizeBytes(EXPORT_PATH));
+        } else {
+            std::cerr << "Failed to export collection to " << EXPORT_PATH << std::endl;
+        }
+        removePath(EXPORT_PATH);
+        
+        // Streaming import: one JSON line is parsed and inserted at a time
+        const std::string importCollection = COLLECTION_NAME + "_import";
+        uint64_t importBytes = writeImportFile(IMPORT_FILE_PATH, NUM_DOCUMENTS);
+        anudb::Collection* target = createScratchCollection(importCollection);
+        if (!target) return false;
+        
+        int imported = 0;
+        double importTime = measureTime([&]() {
+            std::ifstream in(IMPORT_FILE_PATH.c_str());
+            std::string line;
+            while (std::getline(in, line)) {
+                json productData = json::parse(line);
+                anudb::Document doc(productData["id"].get<std::string>(), productData);
+                if (inEngine([&]() { return target->createDocument(doc); }).ok()) {
+                    imported++;
+                }
+            }
+        });
+        recordPhaseResult("Import JSON-lines", importTime, imported, importBytes);
+        inEngine([&]() { return db->dropCollection(importCollection); });
+        std::remove(IMPORT_FILE_PATH.c_str());
+        
+        // Optional partitioned scan: each thread reads one slice of the price range
+        if (benchmarkOptions.scanThreads > 0) {
+            int partitions = benchmarkOptions.scanThreads;
+            std::atomic<size_t> partitionDocs(0);
+            std::vector<std::thread> threads;
+            double parallelTime = measureTime([&]() {
+                for (int t = 0; t < partitions; t++) {
+                    threads.emplace_back([&, t]() {
+                        double low, high;
+                        scanPartition(t, partitions, low, high);
+                        size_t count = 0;
+                        json query = {{"$and", {{{"$gt", {{"price", low}}}}, {{"$lt", {{"price", high}}}}}}};
+                        for (const std::string& docId : inEngine([&]() { return collection->findDocument(query); })) {
+                            anudb::Document doc;
+                            if (inEngine([&]() { return collection->readDocument(docId, doc); }).ok()) {
+                                count++;
+                            }
+                        }
+                        partitionDocs.fetch_add(count);
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+            });
+            recordPhaseResult("Parallel scan " + std::to_string(partitions) + " thr", parallelTime,
+                              partitionDocs.load(), scanned > 0 ? scanBytes * partitionDocs.load() / scanned : 0);
+        }
+        
+        return true;
+    }
+    
+    uint64_t footprintBytes() override {
+        return pathSizeBytes(DB_PATH_ANUDB);
+    }
+    
+    bool runPartialUpdateTest() override {
+        if (!db) return false;
+        
+        const std::string partialCollection = "products_partial";
+        const std::vector<int> targets = partialUpdateTargets();
+        for (const auto& docSize : PARTIAL_UPDATE_SIZES) {
+            anudb::Collection* target = createScratchCollection(partialCollection);
+            if (!target) return false;
+            for (int i = 0; i < PARTIAL_UPDATE_DOCUMENTS; i++) {
+                anudb::Document doc(makeDocId("prod", i), generatePartialUpdateProduct(i, docSize));
+                inEngine([&]() { return target->createDocument(doc); });
+            }
+            
+            for (const auto& op : PARTIAL_UPDATE_OPERATORS) {
+                // In-engine operator, skipped when this AnuDB build rejects it
+                std::string probeId = makeDocId("prod", 0);
+                json probe = partialUpdateOperator(op, 0);
+                bool native = inEngine([&]() { return target->updateDocument(probeId, probe); }).ok();
+                if (native) {
+                    LatencyStats latency;
+                    for (size_t r = 0; r < targets.size(); r++) {
+                        std::string docId = makeDocId("prod", targets[r]);
+                        json update = partialUpdateOperator(op, r);
+                        latency.add(measureLatency([&]() {
+                            inEngine([&]() { return target->updateDocument(docId, update); });
+                        }));
+                    }
+                    // RocksDB stores the whole document under its key, so every update rewrites all of it
+                    uint64_t rewritten = documentBytes(target, targets);
+                    recordPartialUpdate("Partial " + docSize + " " + op, latency, rewritten, 0);
+                } else {
+                    std::cout << "    AnuDB " << op << ": not supported, in-engine update skipped" << std::endl;
+                }
+                
+                // Read-modify-write: fetch the whole document, change it here, write every field back
+                LatencyStats latency;
+                uint64_t clientBytes = 0;
+                for (size_t r = 0; r < targets.size(); r++) {
+                    std::string docId = makeDocId("prod", targets[r]);
+                    latency.add(measureLatency([&]() {
+                        anudb::Document doc;
+                        if (inEngine([&]() { return target->readDocument(docId, doc); }).ok()) {
+                            json product = doc.data();
+                            applyPartialUpdate(product, op, r);
+                            json update = {{"$set", product}};
+                            inEngine([&]() { return target->updateDocument(docId, update); });
+                            clientBytes += doc.data().dump().size() + product.dump().size();
+                        }
+                    }));
+                }
+                recordPartialUpdate("RMW " + docSize + " " + op, latency, documentBytes(target, targets), clientBytes);
+            }
+        }
+        
+        inEngine([&]() { return db->dropCollection(partialCollection); });
+        return true;
+    }
+    
+    bool runTombstoneTest() override {
+        if (!db) return false;
+        
+        const std::string tombstoneCollection = "products_tombstone";
+        for (int fraction : DELETE_FRACTIONS) {
+            const std::string suffix = " " + std::to_string(fraction) + "%";
+            anudb::Collection* target = createScratchCollection(tombstoneCollection);
+            if (!target) return false;
+            inEngine([&]() { return target->createIndex("price"); });
+            insertProducts(target, TOMBSTONE_DOCUMENTS);
+            
+            // Delete the oldest documents, lowest index first
+            int deleted = TOMBSTONE_DOCUMENTS * fraction / 100;
+            int deleteCount = 0;
+            double deleteTime = measureTime([&]() {
+                for (int i = 0; i < deleted; i++) {
+                    std::string docId = makeDocId("prod", i);
+                    if (inEngine([&]() { return target->deleteDocument(docId); }).ok()) {
+                        deleteCount++;
+                    }
+                }
+            });
+            recordPhaseResult("Delete" + suffix, deleteTime, deleteCount);
+            uint64_t deletedBytes = pathSizeBytes(DB_PATH_ANUDB);
+            timeTombstoneReads(target, deleted, suffix);
+            
+            // AnuDB exposes no manual compaction, so rewrite the survivors into a fresh
+            // collection: dropping the old one discards its tombstones wholesale
+            const std::string compactedCollection = tombstoneCollection + "_compacted";
+            anudb::Collection* compacted = nullptr;
+            double compactTime = measureTime([&]() {
+                std::vector<anudb::Document> survivors;
+                inEngine([&]() { return target->readAllDocuments(survivors, std::numeric_limits<uint64_t>::max()); });
+                compacted = createScratchCollection(compactedCollection);
+                if (!compacted) return;
+                inEngine([&]() { return compacted->createIndex("price"); });
+                for (auto& doc : survivors) {
+                    inEngine([&]() { return compacted->createDocument(doc); });
+                }
+                inEngine([&]() { return db->dropCollection(tombstoneCollection); });
+            });
+            if (!compacted) return false;
+            // Labelled as a rewrite so the row does not line up with SQLite's VACUUM
+            recordPhaseResult("Rewrite" + suffix, compactTime, TOMBSTONE_DOCUMENTS - deleteCount);
+            std::cout << "    AnuDB" << suffix << " deleted: " << std::fixed << std::setprecision(2)
+                      << deletedBytes / (1024.0 * 1024.0) << " MB after deletes, "
+                      << pathSizeBytes(DB_PATH_ANUDB) / (1024.0 * 1024.0) << " MB after rewrite" << std::endl;
+            timeTombstoneReads(compacted, deleted, suffix + " rewritten");
+            inEngine([&]() { return db->dropCollection(compactedCollection); });
+        }
+        return true;
+    }
+    
+    bool runTimeSeriesTest() override {
+        if (!db) return false;
+        
+        const std::string readingsCollection = "readings";
+        anudb::Collection* target = createScratchCollection(readingsCollection);
+        if (!target) return false;
+        inEngine([&]() { return target->createIndex("ts"); });
+        
+        std::atomic<bool> running(true);
+        LatencyStats queryLatency;
+        std::thread queryThread([&]() {
+            while (running.load()) {
+                json query = {{"$gt", {{"ts", nowMillis() - benchmarkOptions.tsWindow * 1000LL}}}};
+                queryLatency.add(measureLatency([&]() {
+                    for (const std::string& docId : inEngine([&]() { return target->findDocument(query); })) {
+                        anudb::Document doc;
+                        inEngine([&]() { return target->readDocument(docId, doc); });
+                    }
+                }));
+                std::this_thread::sleep_for(std::chrono::milliseconds(TS_QUERY_INTERVAL_MS));
+            }
+        });
+        
+        // Expiry: find everything older than the retention period and delete it
+        LatencyStats expiryLatency;
+        size_t expired = 0;
+        uint64_t peakBytes = 0;
+        std::thread expiryThread([&]() {
+            while (running.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(TS_EXPIRY_INTERVAL_MS));
+                json query = {{"$lt", {{"ts", nowMillis() - benchmarkOptions.tsRetention * 1000LL}}}};
+                expiryLatency.add(measureLatency([&]() {
+                    for (const std::string& docId : inEngine([&]() { return target->findDocument(query); })) {
+                        if (inEngine([&]() { return target->deleteDocument(docId); }).ok()) {
+                            expired++;
+                        }
+                    }
+                }));
+                peakBytes = std::max(peakBytes, footprintBytes());
+            }
+        });
+        
+        LatencyStats appendLatency;
+        uint64_t appendBytes = 0;
+        size_t appended = 0;
+        double ingestTime = measureTime([&]() {
+            appended = paceAppends([&](size_t seq, int64_t tsMs) {
+                json reading = generateReading(seq, tsMs);
+                appendBytes += reading.dump().size();
+                anudb::Document doc(reading["id"].get<std::string>(), reading);
+                appendLatency.add(measureLatency([&]() {
+                    inEngine([&]() { return target->createDocument(doc); });
+                }));
+            });
+        });
+        running = false;
+        queryThread.join();
+        expiryThread.join();
+        
+        recordPhaseResult("TS ingest", ingestTime, appended, appendBytes);
+        recordPhaseResult("TS append", appendLatency);
+        recordPhaseResult("TS window query", queryLatency);
+        recordPhaseResult("TS expiry pass", expiryLatency);
+        reportTimeSeries(appended, ingestTime, expired, peakBytes, footprintBytes());
+        
+        inEngine([&]() { return db->dropCollection(readingsCollection); });
+        return true;
+    }
+    
+    bool runSoakTest() override {
+        if (!db) return false;
+        
+        const std::string soakCollection = "products_soak";
+        anudb::Collection* target = createScratchCollection(soakCollection);
+        if (!target) return false;
+        inEngine([&]() { return target->createIndex("price"); });
+        insertProducts(target, NUM_DOCUMENTS);
+        
+        bool completed = soakLoop(NUM_DOCUMENTS, [&](SoakOp op, int index, const json& product) {
+            std::string docId = makeDocId("prod", index);
+            anudb::Document doc;
+            switch (op) {
+                case SOAK_READ:
+                    inEngine([&]() { return target->readDocument(docId, doc); });
+                    break;
+                case SOAK_INSERT:
+                    doc = anudb::Document(docId, product);
+                    inEngine([&]() { return target->createDocument(doc); });
+                    break;
+                case SOAK_UPDATE: {
+                    json update = {{"$set", {{"price", partialUpdatePrice(index)}}}};
+                    inEngine([&]() { return target->updateDocument(docId, update); });
+                    break;
+                }
+                case SOAK_DELETE:
+                    inEngine([&]() { return target->deleteDocument(docId); });
+                    break;
+                case SOAK_QUERY: {
+                    double low = partialUpdatePrice(index);
+                    json query = {{"$and", {{{"$gt", {{"price", low}}}}, {{"$lt", {{"price", low + 2.0}}}}}}};
+                    for (const std::string& matchId : inEngine([&]() { return target->findDocument(query); })) {
+                        inEngine([&]() { return target->readDocument(matchId, doc); });
+                    }
+                    break;
+                }
+            }
+        });
+        
+        inEngine([&]() { return db->dropCollection(soakCollection); });
+        return completed;
+    }
+    
+    bool runInterferenceTest() override {
+        if (!db) return false;
+        
+        const std::string rwCollection = "products_rw";
+        anudb::Collection* target = createScratchCollection(rwCollection);
+        if (!target) return false;
+        inEngine([&]() { return target->createIndex("price"); });
+        insertProducts(target, NUM_DOCUMENTS);
+        
+        interferenceLoop(
+            [&](int, bool range, int index) {
+                anudb::Document doc;
+                if (!range) {
+                    std::string docId = makeDocId("prod", index);
+                    inEngine([&]() { return target->readDocument(docId, doc); });
+                    return;
+                }
+                double low = partialUpdatePrice(index);
+                json query = {{"$and", {{{"$gt", {{"price", low}}}}, {{"$lt", {{"price", low + 2.0}}}}}}};
+                for (const std::string& docId : inEngine([&]() { return target->findDocument(query); })) {
+                    inEngine([&]() { return target->readDocument(docId, doc); });
+                }
+            },
+            [&](int, bool insert, const std::string& docId, const json& product) {
+                if (insert) {
+                    anudb::Document doc(docId, product);
+                    inEngine([&]() { return target->createDocument(doc); });
+                } else {
+                    json update = {{"$set", {{"price", product["price"]}, {"stock", product["stock"]}}}};
+                    inEngine([&]() { return target->updateDocument(docId, update); });
+                }
+            });
+        
+        inEngine([&]() { return db->dropCollection(rwCollection); });
+        return true;
+    }
+    
+    bool runCheckpointTest() override {
+        if (!db) return false;
+        
+        // AnuDB exposes no checkpoint control; RocksDB's WAL is the *.log files it
+        // recycles as memtables flush, so its growth is followed the same way
+        const std::string walCollection = "products_wal";
+        anudb::Collection* target = createScratchCollection(walCollection);
+        if (!target) return false;
+        walWriteLoop(
+            [&](int index, const json& product) {
+                anudb::Document doc(makeDocId("prod", index), product);
+                inEngine([&]() { return target->createDocument(doc); });
+            },
+            [&]() { return filesSizeBytes(DB_PATH_ANUDB, ".log"); });
+        inEngine([&]() { return db->dropCollection(walCollection); });
+        return true;
+    }
+
+    bool runColdStartTest() override {
+        if (!db) return false;
+
+        // The cold store lives in its own directory so the main database stays open; whatever
+        // RocksDB leaves in its *.log files on close is replayed inside the timed reopen
+        const std::string coldPath = DB_PATH_ANUDB + "_cold";
+        std::unique_ptr<anudb::Database> coldDb;
+        anudb::Collection* target = nullptr;
+        bool completed = coldStartLoop({coldPath},
+            [&](int size) {
+                removePath(coldPath);
+                coldDb = inEngine([&]() { return std::make_unique<anudb::Database>(coldPath); });
+                if (!inEngine([&]() { return coldDb->open(); }).ok() ||
+                    !inEngine([&]() { return coldDb->createCollection(COLLECTION_NAME); }).ok()) {
+                    return false;
+                }
+                target = inEngine([&]() { return coldDb->getCollection(COLLECTION_NAME); });
+                if (!target) return false;
+                inEngine([&]() { return target->createIndex("price"); });
+                int loaded = insertProducts(target, size);
+                return inEngine([&]() { return coldDb->close(); }).ok() && loaded == size;
+            },
+            [&]() { return filesSizeBytes(coldPath, ".log"); },
+            [&]() {
+                coldDb = inEngine([&]() { return std::make_unique<anudb::Database>(coldPath); });
+                if (!inEngine([&]() { return coldDb->open(); }).ok()) return false;
+                target = inEngine([&]() { return coldDb->getCollection(COLLECTION_NAME); });
+                return target != nullptr;
+            },
+            [&](int index) {
+                std::string docId = makeDocId("prod", index);
+                anudb::Document doc;
+                inEngine([&]() { return target->readDocument(docId, doc); });
+            },
+            [&](int index) {
+                anudb::Document doc;
+                double low = partialUpdatePrice(index);
+                json query = {{"$and", {{{"$gt", {{"price", low}}}}, {{"$lt", {{"price", low + 2.0}}}}}}};
+                for (const std::string& docId : inEngine([&]() { return target->findDocument(query); })) {
+                    inEngine([&]() { return target->readDocument(docId, doc); });
+                }
+            },
+            [&]() {
+                inEngine([&]() { return coldDb->close(); });
+                target = nullptr;
+            });
+        coldDb.reset();
+        removePath(coldPath);
+        return completed;
+    }
+
+    bool runCrashTest() override {
+        if (!db) return false;
+
+        // AnuDB has no durability knob, so RocksDB's default WAL behaviour is the one setting
+        const std::string crashPath = DB_PATH_ANUDB + "_crash";
+        std::unique_ptr<anudb::Database> crashDb;
+        anudb::Collection* target = nullptr;
+        bool completed = crashLoop({"default"},
+            [&]() { return filesSizeBytes(crashPath, ".log"); },
+            [&](int lastAcked) {
+                crashDb = inEngine([&]() { return std::make_unique<anudb::Database>(crashPath); });
+                if (!inEngine([&]() { return crashDb->open(); }).ok()) return false;
+                target = inEngine([&]() { return crashDb->getCollection(COLLECTION_NAME); });
+                if (!target) return false;
+                std::string docId = makeDocId("prod", lastAcked);
+                anudb::Document doc;
+                inEngine([&]() { return target->readDocument(docId, doc); });
+                return true;
+            },
+            [&](int index) {
+                std::string docId = makeDocId("prod", index);
+                anudb::Document doc;
+                return inEngine([&]() { return target->readDocument(docId, doc); }).ok();
+            },
+            [&]() {
+                if (crashDb) inEngine([&]() { return crashDb->close(); });
+                target = nullptr;
+            });
+        crashDb.reset();
+        removePath(crashPath);
+        return completed;
+    }
+
+    bool runCrashWriter(const std::string&, int ackFd) override {
+        const std::string crashPath = DB_PATH_ANUDB + "_crash";
+        removePath(crashPath);
+        auto crashDb = inEngine([&]() { return std::make_unique<anudb::Database>(crashPath); });
+        if (!inEngine([&]() { return crashDb->open(); }).ok() ||
+            !inEngine([&]() { return crashDb->createCollection(COLLECTION_NAME); }).ok()) {
+            return false;
+        }
+        anudb::Collection* target = inEngine([&]() { return crashDb->getCollection(COLLECTION_NAME); });
+        if (!target) return false;
+        inEngine([&]() { return target->createIndex("price"); });
+
+        for (int i = 0; i < CRASH_MAX_WRITES; i++) {
+            anudb::Document doc(makeDocId("prod", i), generateRandomProduct(i));
+            if (!inEngine([&]() { return target->createDocument(doc); }).ok() || !acknowledgeWrite(ackFd, i)) return false;
+        }
+        return inEngine([&]() { return crashDb->close(); }).ok();
+    }
+
+    bool runBuilderTest() override {
+        if (!db) return false;
+        
+        // AnuDB documents are nlohmann::json, so flat text would be parsed back before every
+        // insert; only the build side is compared
+        builderBuild();
+        return true;
+    }
+
+    bool runEncodingTest() override {
+        if (!db) return false;
+        
+        // Documents go through the API as nlohmann::json and AnuDB picks its own on-disk
+        // encoding, so there is nothing to select; the SQLite run covers the comparison
+        std::cout << "    AnuDB: storage encoding is internal to AnuDB, encoding phase skipped" << std::endl;
+        return true;
+    }
+
+    bool runNestedQueryTest() override {
+        if (!collection) return false;
+        
+        for (const auto& field : NESTED_FIELDS) {
+            bool indexed = false;
+            double indexTime = measureTime([&]() {
+                indexed = inEngine([&]() { return collection->createIndex(field.path); }).ok();
+            });
+            if (indexed) {
+                recordPhaseResult("Index build " + field.path, indexTime, 1);
+            }
+            
+            // Use the index only if it returns exactly what a harness-side filter finds;
+            // otherwise query the owning category and filter the documents in the harness
+            json query = {{"$eq", {{field.path, field.value}}}};
+            bool native = indexed && findMatching(query).size() == filterCategory(field).size();
+            std::cout << "    AnuDB " << field.path << ": " << (native ? "index" : "harness filter") << std::endl;
+            
+            LatencyStats latency;
+            for (int r = 0; r < NESTED_REPEATS; r++) {
+                latency.add(measureLatency([&]() {
+                    if (native) {
+                        findMatching(query);
+                    } else {
+                        filterCategory(field);
+                    }
+                }));
+            }
+            recordPhaseResult("Eq " + field.path, latency);
+        }
+        
+        // Top-level indexed fields with comparable selectivity, for reference
+        const std::vector<std::pair<std::string, json>> topLevel = {
+            {"Eq category (top)", {{"$eq", {{"category", "Books"}}}}},
+            {"Eq stock (top)", {{"$eq", {{"stock", 100}}}}}
+        };
+        for (const auto& entry : topLevel) {
+            LatencyStats latency;
+            for (int r = 0; r < NESTED_REPEATS; r++) {
+                latency.add(measureLatency([&]() {
+                    findMatching(entry.second);
+                }));
+            }
+            recordPhaseResult(entry.first, latency);
+        }
+        
+        for (const auto& field : NESTED_FIELDS) {
+            inEngine([&]() { return collection->deleteIndex(field.path); });
+        }
+        return true;
+    }
+    
+private:
+    std::unique_ptr<anudb::Database> db;
+    anudb::Collection* collection = nullptr;
+    
+    struct RankedProduct {
+        double key;
+        std::string id;
+        json data;
+    };
+    
+    static bool rankedBefore(const RankedProduct& a, const RankedProduct& b) {
+        return a.key < b.key || (a.key == b.key && a.id < b.id);
+    }
+    
+    // True when findDocument returns ids sorted by field for an $orderBy query
+    bool supportsOrderBy(const std::string& field) {
+        json query = {{"$orderBy", {{field, "asc"}}}};
+        std::vector<std::string> docIds = inEngine([&]() { return collection->findDocument(query); });
+        if (docIds.size() < 2) return false;
+        
+        double previous = std::numeric_limits<double>::lowest();
+        for (size_t i = 0; i < docIds.size() && i < 100; i++) {
+            anudb::Document doc;
+            if (!inEngine([&]() { return collection->readDocument(docIds[i], doc); }).ok()) return false;
+            double value = doc.data().value(field, 0.0);
+            if (value < previous) return false;
+            previous = value;
+        }
+        return true;
+    }
+    
+    // Read every product matching query and return them with field as the sort key
+    std::vector<RankedProduct> readRanked(const json& query, const std::string& field) {
+        std::vector<RankedProduct> rows;
+        for (const std::string& docId : inEngine([&]() { return collection->findDocument(query); })) {
+            anudb::Document doc;
+            if (inEngine([&]() { return collection->readDocument(docId, doc); }).ok()) {
+                RankedProduct row = {doc.data().value(field, 0.0), docId, doc.data()};
+                rows.push_back(row);
+            }
+        }
+        return rows;
+    }
+    
+    // Products [offset, offset + limit) ordered by field, read in full
+    std::vector<RankedProduct> orderedProducts(const std::string& field, bool descending, bool nativeOrdering,
+                                               int offset, int limit) {
+        std::vector<RankedProduct> page;
+        if (nativeOrdering) {
+            json query = {{"$orderBy", {{field, descending ? "desc" : "asc"}}}};
+            std::vector<std::string> docIds = inEngine([&]() { return collection->findDocument(query); });
+            for (size_t i = offset; i < docIds.size() && i < static_cast<size_t>(offset + limit); i++) {
+                anudb::Document doc;
+                if (inEngine([&]() { return collection->readDocument(docIds[i], doc); }).ok()) {
+                    RankedProduct row = {doc.data().value(field, 0.0), docIds[i], doc.data()};
+                    page.push_back(row);
+                }
+            }
+            return page;
+        }
+        
+        std::vector<RankedProduct> rows =
+            readRanked({{"$gt", {{field, std::numeric_limits<double>::lowest()}}}}, field);
+        size_t end = std::min(rows.size(), static_cast<size_t>(offset + limit));
+        std::partial_sort(rows.begin(), rows.begin() + end, rows.end(),
+            [&](const RankedProduct& a, const RankedProduct& b) {
+                return descending ? rankedBefore(b, a) : rankedBefore(a, b);
+            });
+        if (static_cast<size_t>(offset) < end) {
+            page.assign(rows.begin() + offset, rows.begin() + end);
+        }
+        return page;
     }
     
-    // Get current time as formatted string
-    std::string getCurrentTimeString() {
-	    std::stringstream ss;
-auto now = std::chrono::system_clock::now();
-std::time_t now_time_t = std::chrono::system_clock::to_time_t(now);
-std::tm* tm_info = std::localtime(&now_time_t);
-
-char time_buffer[20]; // "YYYY-MM-DD HH:MM:SS"
-std::strftime(time_buffer, sizeof(time_buffer), "%Y-%m-%d %H:%M:%S", tm_info);
-ss << time_buffer;
-        return ss.str();
+    // Next page after last in (field, id) order, fetched through a range query on field
+    std::vector<RankedProduct> keysetPage(const std::string& field, const RankedProduct& last, int limit) {
+        // Prices carry two decimals, so backing off by half a cent also returns ties on the last key
+        double from = last.id.empty() ? std::numeric_limits<double>::lowest() : last.key - 0.005;
+        std::vector<RankedProduct> rows = readRanked({{"$gt", {{field, from}}}}, field);
+        rows.erase(std::remove_if(rows.begin(), rows.end(),
+            [&](const RankedProduct& row) { return !last.id.empty() && !rankedBefore(last, row); }), rows.end());
+        size_t end = std::min(rows.size(), static_cast<size_t>(limit));
+        std::partial_sort(rows.begin(), rows.begin() + end, rows.end(), rankedBefore);
+        rows.resize(end);
+        return rows;
     }
     
-    // Timer function for benchmarking
-    template<typename Func>
-    double measureTime(Func&& func) {
-        auto start = high_resolution_clock::now();
-        func();
-        auto end = high_resolution_clock::now();
-        return duration_cast<milliseconds>(end - start).count() / 1000.0;
+    // Read every document matching query
+    std::vector<anudb::Document> findMatching(const json& query) {
+        std::vector<anudb::Document> docs;
+        for (const std::string& docId : inEngine([&]() { return collection->findDocument(query); })) {
+            anudb::Document doc;
+            if (inEngine([&]() { return collection->readDocument(docId, doc); }).ok()) {
+                docs.push_back(doc);
+            }
+        }
+        return docs;
+    }
+    
+    // Harness fallback for a nested field: read the owning category and filter on the path
+    std::vector<anudb::Document> filterCategory(const NestedField& field) {
+        std::vector<anudb::Document> matches;
+        for (auto& doc : findMatching({{"$eq", {{"category", field.category}}}})) {
+            const json* value = &doc.data();
+            std::stringstream path(field.path);
+            std::string key;
+            while (value && std::getline(path, key, '.')) {
+                value = value->is_object() && value->count(key) ? &(*value)[key] : nullptr;
+            }
+            if (value && *value == field.value) {
+                matches.push_back(doc);
+            }
+        }
+        return matches;
+    }
+    
+    // Reads over a collection whose first deleted products are gone: point reads of the
+    // deleted ids, a price range query and a full scan, recorded with suffix
+    void timeTombstoneReads(anudb::Collection* target, int deleted, const std::string& suffix) {
+        LatencyStats missLatency;
+        for (int index : deletedProbeTargets(deleted)) {
+            std::string docId = makeDocId("prod", index);
+            missLatency.add(measureLatency([&]() {
+                anudb::Document doc;
+                inEngine([&]() { return target->readDocument(docId, doc); });
+            }));
+        }
+        recordPhaseResult("Deleted reads" + suffix, missLatency);
+        
+        LatencyStats rangeLatency;
+        LatencyStats scanLatency;
+        json query = {{"$and", {{{"$gt", {{"price", 1000.0}}}}, {{"$lt", {{"price", 1100.0}}}}}}};
+        for (int r = 0; r < TOMBSTONE_REPEATS; r++) {
+            rangeLatency.add(measureLatency([&]() {
+                for (const std::string& docId : inEngine([&]() { return target->findDocument(query); })) {
+                    anudb::Document doc;
+                    inEngine([&]() { return target->readDocument(docId, doc); });
+                }
+            }));
+            scanLatency.add(measureLatency([&]() {
+                std::vector<anudb::Document> docs;
+                inEngine([&]() { return target->readAllDocuments(docs, std::numeric_limits<uint64_t>::max()); });
+            }));
+        }
+        recordPhaseResult("Range query" + suffix, rangeLatency);
+        recordPhaseResult("Scan" + suffix, scanLatency);
+    }
+    
+    // AnuDB update document for partial update r with operator op
+    static json partialUpdateOperator(const std::string& op, int r) {
+        if (op == "$set") {
+            return {{"$set", {{"price", partialUpdatePrice(r)}}}};
+        } else if (op == "$inc") {
+            return {{"$inc", {{"stock", 1}}}};
+        } else if (op == "$push") {
+            return {{"$push", {{"tags", "tag" + std::to_string(r)}}}};
+        }
+        return {{"$set", {{"price", partialUpdatePrice(r)}, {"stock", r % 500}}}};
+    }
+    
+    // Serialized size of the listed products in target, read back outside any timed region
+    static uint64_t documentBytes(anudb::Collection* target, const std::vector<int>& indexes) {
+        uint64_t bytes = 0;
+        for (int index : indexes) {
+            std::string docId = makeDocId("prod", index);
+            anudb::Document doc;
+            if (inEngine([&]() { return target->readDocument(docId, doc); }).ok()) {
+                bytes += doc.data().dump().size();
+            }
+        }
+        return bytes;
+    }
+    
+    // Serialized size of documents prefix0..prefix<count-1>, read back outside any timed region
+    uint64_t storedBytes(const std::string& prefix, int count) {
+        uint64_t bytes = 0;
+        for (int i = 0; i < count; i++) {
+            std::string docId = makeDocId(prefix, i);
+            anudb::Document doc;
+            if (inEngine([&]() { return collection->readDocument(docId, doc); }).ok()) {
+                bytes += doc.data().dump().size();
+            }
+        }
+        return bytes;
+    }
+    
+    // Drop any leftover copy of a collection and return a freshly created one
+    anudb::Collection* createScratchCollection(const std::string& name) {
+        inEngine([&]() { return db->dropCollection(name); });
+        auto status = inEngine([&]() { return db->createCollection(name); });
+        if (!status.ok()) {
+            std::cerr << "Failed to create collection " << name << ": " << status.message() << std::endl;
+            return nullptr;
+        }
+        return inEngine([&]() { return db->getCollection(name); });
+    }
+    
+    // Insert products prod0..prod<count-1> and return how many succeeded
+    int insertProducts(anudb::Collection* target, int count) {
+        int successCount = 0;
+        for (int i = 0; i < count; i++) {
+            json productData = generateRandomProduct(i);
+            anudb::Document doc(makeDocId("prod", i), productData);
+            if (inEngine([&]() { return target->createDocument(doc); }).ok()) {
+                successCount++;
+            }
+        }
+        return successCount;
     }
 };
 
-// AnuDB test implementation
-class AnuDBTest : public BenchmarkTest {
+// SQLite3 test implementation
+// SQLite3 test implementation
+class SQLiteTest : public BenchmarkTest {
 public:
-    AnuDBTest() : BenchmarkTest("AnuDB") {}
-    
+    SQLiteTest() : BenchmarkTest("SQLite3") {}
+
     bool setup() override {
-        db = std::make_unique<anudb::Database>(DB_PATH_ANUDB);
-        auto status = db->open();
-        if (!status.ok()) {
-            std::cerr << "Failed to open AnuDB database: " << status.message() << std::endl;
+        // Remove existing database file if it exists
+        std::remove(DB_PATH_SQLITE.c_str());
+        std::remove((DB_PATH_SQLITE + "-wal").c_str());
+        std::remove((DB_PATH_SQLITE + "-shm").c_str());
+
+        const std::string& schema = benchmarkOptions.sqliteSchema;
+        if ((schema == "jsonb" && sqlite3_libversion_number() < 3045000) ||
+            (schema == "generated" && sqlite3_libversion_number() < 3031000)) {
+            std::cerr << "SQLite " << sqlite3_libversion() << " does not support the " << schema << " schema" << std::endl;
             return false;
         }
-        
-        // Create collection
-        status = db->createCollection(COLLECTION_NAME);
-        if (!status.ok() && status.message().find("already exists") == std::string::npos) {
-            std::cerr << "Failed to create collection: " << status.message() << std::endl;
+
+        // Open database
+        int rc = sqlite3_open(DB_PATH_SQLITE.c_str(), &db);
+        if (rc != SQLITE_OK) {
+            std::cerr << "Failed to open SQLite database: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
-        
-        collection = db->getCollection(COLLECTION_NAME);
-        if (!collection) {
-            std::cerr << "Failed to get collection." << std::endl;
+
+        // Enable WAL mode for better concurrency
+        char *errMsg = nullptr;
+        rc = sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "Failed to set WAL mode: " << errMsg << std::endl;
+            sqlite3_free(errMsg);
             return false;
         }
-        
-        // Create indexes
-        for (const auto& field : {"price", "stock", "category", "rating", "available"}) {
-            status = collection->createIndex(field);
-            if (!status.ok() && status.message().find("already exists") == std::string::npos) {
-                std::cerr << "Failed to create index on " << field << ": " << status.message() << std::endl;
+        configureConnection(db);
+        startCheckpointer();
+
+        // Create products table - simplified to match AnuDB's document approach
+        if (!execSQL(createTableSQL("products"))) {
+            return false;
+        }
+
+        // Create indexes (same as AnuDB)
+        for (const auto& field : INDEX_FIELDS) {
+            if (!execSQL(createIndexSQL("products", field))) {
                 return false;
             }
         }
-        
+
+        // Prepare statements
+        rc = sqlite3_prepare_v2(db, insertSQL("products").c_str(), -1, &insertStmt, nullptr);
+
+        if (rc != SQLITE_OK) {
+            std::cerr << "Failed to prepare insert statement: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+
         return true;
     }
-    
+
     bool cleanup() override {
-        if (!db) return false;
-        auto status = db->close();
-        return status.ok();
+        stopCheckpointer();
+
+        if (insertStmt) {
+            sqlite3_finalize(insertStmt);
+            insertStmt = nullptr;
+        }
+
+        if (db) {
+            sqlite3_close(db);
+            db = nullptr;
+        }
+
+        return true;
     }
-    
+
     bool runInsertTest() override {
-        if (!collection) return false;
-        
+        if (!db || !insertStmt) return false;
+
         int successCount = 0;
         results.insertTime = measureTime([&]() {
+            // Begin transaction for bulk insert
+            char* errMsg = nullptr;
+            int rc = sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
+            if (rc != SQLITE_OK) {
+                std::cerr << "Failed to begin transaction: " << errMsg << std::endl;
+                sqlite3_free(errMsg);
+                return;
+            }
+
             for (int i = 0; i < NUM_DOCUMENTS; i++) {
                 json productData = generateRandomProduct(i);
-                std::string docId = "prod" + std::to_string(i);
-                
-                anudb::Document doc(docId, productData);
-                auto status = collection->createDocument(doc);
-                
-                if (status.ok()) {
+                std::string docId = makeDocId("prod", i);
+                const std::string& jsonStr = serializeDocument(productData);
+
+                // Bind parameters - now focusing on storing the whole JSON document
+                sqlite3_reset(insertStmt);
+                bindProduct(insertStmt, docId, jsonStr, productData);
+
+                rc = sqlite3_step(insertStmt);
+                if (rc == SQLITE_DONE) {
                     successCount++;
+                    results.insertBytes += jsonStr.size();
                 }
             }
+
+            // Commit transaction
+            rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg);
+            if (rc != SQLITE_OK) {
+                std::cerr << "Failed to commit transaction: " << errMsg << std::endl;
+                sqlite3_free(errMsg);
+            }
         });
-        
+
         results.insertOps = successCount;
         return true;
     }
-    
+
     bool runQueryTest() override {
-        if (!collection) return false;
-        
+        if (!db) return false;
+
         int successCount = 0;
-        std::vector<json> queries = {
-            // Query by category
-            {{"$eq", {{"category", "Electronics"}}}},
-            {{"$eq", {{"category", "Books"}}}},
-            {{"$eq", {{"category", "Food"}}}},
-            {{"$eq", {{"category", "Clothing"}}}},
-            
-            // Query by price range
-            {{"$gt", {{"price", 500.0}}}},
-            {{"$lt", {{"price", 100.0}}}},
-            {{"$and", {
-                {{"$gt", {{"price", 100.0}}}},
-                {{"$lt", {{"price", 500.0}}}}
-            }}},
-            
-            // Query by rating
-            {{"$gt", {{"rating", 4.0}}}},
-            
-            // Query by availability
-            {{"$eq", {{"available", true}}}},
-            
+        const std::string select = "SELECT id, " + documentSQL() + " FROM products WHERE ";
+        const std::string category = fieldSQL("category");
+        const std::string price = fieldSQL("price");
+        std::vector<std::string> queries = {
+            // By category
+            select + category + " = 'Electronics';",
+            select + category + " = 'Books';",
+            select + category + " = 'Food';",
+            select + category + " = 'Clothing';",
+
+            // By price range
+            select + price + " > 500.0;",
+            select + price + " < 100.0;",
+            select + price + " > 100.0 AND " + price + " < 500.0;",
+
+            // By rating
+            select + fieldSQL("rating") + " > 4.0;",
+
+            // By availability
+            select + fieldSQL("available") + " = 1;",
+
             // Combined queries
-            {{"$and", {
-                {{"$eq", {{"category", "Electronics"}}}},
-                {{"$gt", {{"price", 1000.0}}}}
-            }}}
+            select + category + " = 'Electronics' AND " + price + " > 1000.0;"
         };
-        
+
         results.queryTime = measureTime([&]() {
             for (int i = 0; i < NUM_QUERIES; i++) {
-                const json& query = queries[i % queries.size()];
-                std::vector<std::string> docIds = collection->findDocument(query);
-                successCount += docIds.size() > 0 ? 1 : 0;
+                const std::string& query = queries[i % queries.size()];
+
+                sqlite3_stmt* stmt;
+                int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
+
+                if (rc == SQLITE_OK) {
+                    int count = 0;
+                    while (sqlite3_step(stmt) == SQLITE_ROW) {
+                        // The document data is in the second column (index 1)
+                        const char* jsonData = documentColumn(stmt, 1);
+                        results.queryBytes += sqlite3_column_bytes(stmt, 1);
+                        // Parse the JSON to simulate what AnuDB would do with the returned document
+                        //json doc = json::parse(jsonData);
+                        count++;
+                    }
+
+                    if (count > 0) {
+                        successCount++;
+                    }
+                }
+
+                sqlite3_finalize(stmt);
             }
         });
-        
+
         results.queryOps = NUM_QUERIES;
         return true;
     }
-    
+
     bool runUpdateTest() override {
-        if (!collection) return false;
-        
+        if (!db) return false;
+
         int successCount = 0;
         results.updateTime = measureTime([&]() {
+            // Begin transaction for bulk update
+            char* errMsg = nullptr;
+            int rc = sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
+            if (rc != SQLITE_OK) {
+                std::cerr << "Failed to begin transaction: " << errMsg << std::endl;
+                sqlite3_free(errMsg);
+                return;
+            }
+
             for (int i = 0; i < NUM_DOCUMENTS / 2; i++) {
-                std::string docId = "prod" + std::to_string(i);
-                
-                // Generate update data
-                json updateData = {
-                    {"$set", {
-                        {"price", 100.0 + (i % 10) * 50.0},
-                        {"stock", 10 + (i % 20)},
-                        {"updated_at", getCurrentTimeString()}
-                    }}
-                };
-                
-                auto status = collection->updateDocument(docId, updateData);
-                if (status.ok()) {
-                    successCount++;
+                std::string docId = makeDocId("prod", i);
+                double newPrice = 100.0 + (i % 10) * 50.0;
+                int newStock = 10 + (i % 20);
+
+                // First, fetch the existing JSON document
+                std::string selectSQL = "SELECT " + documentSQL() + " FROM products WHERE id = ?;";
+                sqlite3_stmt* selectStmt;
+                rc = sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &selectStmt, nullptr);
+
+                if (rc == SQLITE_OK) {
+                    sqlite3_bind_text(selectStmt, 1, docId.c_str(), -1, bindLifetime());
+
+                    if (sqlite3_step(selectStmt) == SQLITE_ROW) {
+                        // Get the JSON data
+                        json productData = parseDocumentColumn(selectStmt, 0);
+
+                        // Update the JSON data
+                        productData["price"] = newPrice;
+                        productData["stock"] = newStock;
+                        productData["updated_at"] = getCurrentTimeString();
+
+                        // Now update the database - update both the JSON document and the indexed fields
+                        sqlite3_stmt* updateStmt;
+                        rc = sqlite3_prepare_v2(db, updateSQL().c_str(), -1, &updateStmt, nullptr);
+
+                        if (rc == SQLITE_OK) {
+                            const std::string& updatedJsonStr = serializeDocument(productData);
+
+                            bindUpdate(updateStmt, updatedJsonStr, newPrice, newStock, docId);
+
+                            rc = sqlite3_step(updateStmt);
+                            if (rc == SQLITE_DONE) {
+                                successCount++;
+                                results.updateBytes += updatedJsonStr.size();
+                            }
+
+                            sqlite3_finalize(updateStmt);
+                        }
+                    }
+
+                    sqlite3_finalize(selectStmt);
                 }
             }
+
+            // Commit transaction
+            rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg);
+            if (rc != SQLITE_OK) {
+                std::cerr << "Failed to commit transaction: " << errMsg << std::endl;
+                sqlite3_free(errMsg);
+            }
         });
-        
+
         results.updateOps = successCount;
         return true;
     }
-    
+
     bool runDeleteTest() override {
-        if (!collection) return false;
-        
+        if (!db) return false;
+
         int successCount = 0;
         results.deleteTime = measureTime([&]() {
+            // Begin transaction for bulk delete
+            char* errMsg = nullptr;
+            int rc = sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
+            if (rc != SQLITE_OK) {
+                std::cerr << "Failed to begin transaction: " << errMsg << std::endl;
+                sqlite3_free(errMsg);
+                return;
+            }
+
             for (int i = 0; i < NUM_DOCUMENTS / 4; i++) {
-                std::string docId = "prod" + std::to_string(i * 3);  // Delete every third document
-                
-                auto status = collection->deleteDocument(docId);
-                if (status.ok()) {
-                    successCount++;
+                std::string docId = makeDocId("prod", i * 3);  // Delete every third document
+
+                std::string deleteSQL = "DELETE FROM products WHERE id = ?;";
+                sqlite3_stmt* deleteStmt;
+                rc = sqlite3_prepare_v2(db, deleteSQL.c_str(), -1, &deleteStmt, nullptr);
+
+                if (rc == SQLITE_OK) {
+                    sqlite3_bind_text(deleteStmt, 1, docId.c_str(), -1, bindLifetime());
+
+                    rc = sqlite3_step(deleteStmt);
+                    if (rc == SQLITE_DONE) {
+                        successCount++;
+                    }
+
+                    sqlite3_finalize(deleteStmt);
                 }
             }
+
+            // Commit transaction
+            rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg);
+            if (rc != SQLITE_OK) {
+                std::cerr << "Failed to commit transaction: " << errMsg << std::endl;
+                sqlite3_free(errMsg);
+            }
         });
-        
+
         results.deleteOps = successCount;
         return true;
     }
-    
+
     bool runParallelTest() override {
-        if (!collection) return false;
-        
+        if (!db) return false;
+
         std::vector<std::thread> threads;
+        std::vector<CpuPlacement> placements(NUM_THREADS);
         std::atomic<int> successCount(0);
+        std::atomic<uint64_t> successBytes(0);
         std::mutex mtx;
-        
+
         // Create a barrier to synchronize thread start
         std::atomic<int> barrier(0);
-        
+
         auto start = high_resolution_clock::now();
-        
-        // Spawn threads
+
+        // Each thread will need its own connection to the database
         for (int t = 0; t < NUM_THREADS; t++) {
             threads.emplace_back([&, t]() {
                 // Wait until all threads are ready
@@ -345,587 +3642,1781 @@ public:
                 while (barrier.load() < NUM_THREADS) {
                     std::this_thread::yield();
                 }
-                
+                pinWorker(t);
+                CpuPlacement& placement = placements[t];
+                placement.start();
+
+                // Open a new connection for this thread
+                sqlite3* threadDb;
+                int rc = sqlite3_open(DB_PATH_SQLITE.c_str(), &threadDb);
+                if (rc != SQLITE_OK) {
+                    std::cerr << "Thread " << t << " failed to open database: " << sqlite3_errmsg(threadDb) << std::endl;
+                    return;
+                }
+                configureConnection(threadDb);
+
+                // Create prepared statement for inserts
+                sqlite3_stmt* threadInsertStmt;
+                rc = sqlite3_prepare_v2(threadDb, insertSQL("products").c_str(), -1, &threadInsertStmt, nullptr);
+
+                if (rc != SQLITE_OK) {
+                    std::cerr << "Thread " << t << " failed to prepare insert statement: " << sqlite3_errmsg(threadDb) << std::endl;
+                    sqlite3_close(threadDb);
+                    return;
+                }
+
                 int threadSuccessCount = 0;
+                uint64_t threadBytes = 0;
                 int docsPerThread = NUM_DOCUMENTS / NUM_THREADS;
                 int startIdx = t * docsPerThread;
                 int endIdx = startIdx + docsPerThread;
-                
+
+                // Begin transaction
+                char* errMsg = nullptr;
+                rc = sqlite3_exec(threadDb, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
+                if (rc != SQLITE_OK) {
+                    std::cerr << "Thread " << t << " failed to begin transaction: " << errMsg << std::endl;
+                    sqlite3_free(errMsg);
+                    sqlite3_finalize(threadInsertStmt);
+                    sqlite3_close(threadDb);
+                    return;
+                }
+
                 // Each thread performs a mix of operations
                 for (int i = startIdx; i < endIdx; i++) {
-                    std::string docId = "parallel_prod" + std::to_string(i);
-                    
+                    std::string docId = makeDocId("parallel_prod", i);
+
                     // Insert
                     json productData = generateRandomProduct(i + 10000);  // Offset to avoid conflicts
-                    anudb::Document doc(docId, productData);
-                    auto status = collection->createDocument(doc);
-                    if (status.ok()) {
+                    const std::string& jsonStr = serializeDocument(productData);
+
+                    sqlite3_reset(threadInsertStmt);
+                    bindProduct(threadInsertStmt, docId, jsonStr, productData);
+
+                    rc = sqlite3_step(threadInsertStmt);
+                    if (rc == SQLITE_DONE) {
                         threadSuccessCount++;
+                        threadBytes += jsonStr.size();
                     }
-                    
-                    // Query
+
+                    // Query - using indexed fields when possible
                     if (i % 5 == 0) {
-                        json query = {{"$eq", {{"category", productData["category"].get<std::string>()}}}};
-			std::vector<std::string> docIds;
-                        docIds = collection->findDocument(query);
-			for (const std::string& docId : docIds) {
-			    anudb::Document doc;
-			    collection->readDocument(docId, doc);
-			}
+                        const std::string& category = productData["category"].get_ref<const std::string&>();
+                        std::string querySQL = "SELECT id, " + documentSQL() + " FROM products WHERE " + fieldSQL("category") + " = ?;";
+                        sqlite3_stmt* queryStmt;
+                        rc = sqlite3_prepare_v2(threadDb, querySQL.c_str(), -1, &queryStmt, nullptr);
+
+                        if (rc == SQLITE_OK) {
+                            sqlite3_bind_text(queryStmt, 1, category.c_str(), -1, bindLifetime());
+
+                            while (sqlite3_step(queryStmt) == SQLITE_ROW) {
+                                // Parse the returned JSON to simulate AnuDB behavior
+                                json doc = parseDocumentColumn(queryStmt, 1);
+                            }
+
+                            sqlite3_finalize(queryStmt);
+                        }
                     }
-                    
-                    // Update
+
+                    // Update - now updating both JSON document and indexed fields
                     if (i % 3 == 0) {
-                        json updateData = {
-                            {"$set", {
-                                {"price", (double)productData["price"] * 1.1},
-                                {"stock", i % 100},
-                                {"updated_at", getCurrentTimeString()}
-                            }}
-                        };
-                        collection->updateDocument(docId, updateData);
+                        double newPrice = productData["price"].get<double>() * 1.1;
+                        int newStock = i % 100;
+                        
+                        // First get the current JSON document
+                        std::string selectSQL = "SELECT " + documentSQL() + " FROM products WHERE id = ?;";
+                        sqlite3_stmt* selectStmt;
+                        rc = sqlite3_prepare_v2(threadDb, selectSQL.c_str(), -1, &selectStmt, nullptr);
+                        
+                        if (rc == SQLITE_OK) {
+                            sqlite3_bind_text(selectStmt, 1, docId.c_str(), -1, bindLifetime());
+                            
+                            if (sqlite3_step(selectStmt) == SQLITE_ROW) {
+                                // Get and update the JSON document
+                                json docData = parseDocumentColumn(selectStmt, 0);
+                                
+                                // Modify the document
+                                docData["price"] = newPrice;
+                                docData["stock"] = newStock;
+                                docData["updated_at"] = getCurrentTimeString();
+                                
+                                // Update the document and indexed fields
+                                sqlite3_stmt* updateStmt;
+                                rc = sqlite3_prepare_v2(threadDb, updateSQL().c_str(), -1, &updateStmt, nullptr);
+                                
+                                if (rc == SQLITE_OK) {
+                                    const std::string& updatedJsonStr = serializeDocument(docData);
+                                    
+                                    bindUpdate(updateStmt, updatedJsonStr, newPrice, newStock, docId);
+                                    
+                                    sqlite3_step(updateStmt);
+                                    sqlite3_finalize(updateStmt);
+                                }
+                            }
+                            
+                            sqlite3_finalize(selectStmt);
+                        }
                     }
-                    
+
                     // Delete
                     if (i % 7 == 0) {
-                        collection->deleteDocument(docId);
+                        std::string deleteSQL = "DELETE FROM products WHERE id = ?;";
+                        sqlite3_stmt* deleteStmt;
+                        rc = sqlite3_prepare_v2(threadDb, deleteSQL.c_str(), -1, &deleteStmt, nullptr);
+
+                        if (rc == SQLITE_OK) {
+                            sqlite3_bind_text(deleteStmt, 1, docId.c_str(), -1, bindLifetime());
+
+                            sqlite3_step(deleteStmt);
+                            sqlite3_finalize(deleteStmt);
+                        }
+                    }
+                    placement.sample();
+                }
+                placement.finish();
+
+                // Commit transaction
+                rc = sqlite3_exec(threadDb, "COMMIT;", nullptr, nullptr, &errMsg);
+                if (rc != SQLITE_OK) {
+                    std::cerr << "Thread " << t << " failed to commit transaction: " << errMsg << std::endl;
+                    sqlite3_free(errMsg);
+                }
+
+                // Clean up
+                sqlite3_finalize(threadInsertStmt);
+                sqlite3_close(threadDb);
+
+                successCount.fetch_add(threadSuccessCount);
+                successBytes.fetch_add(threadBytes);
+            });
+        }
+
+        // Join all threads
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto end = high_resolution_clock::now();
+        results.parallelTime = duration_cast<milliseconds>(end - start).count() / 1000.0;
+        results.parallelOps = successCount.load();
+        results.parallelBytes = successBytes.load();
+        reportPlacement(placements, results.parallelTime);
+
+        return true;
+    }
+
+    bool runIndexTest() override {
+        if (!db) return false;
+
+        const std::string benchTable = "products_index_bench";
+
+        // Insert throughput with 0..N secondary indexes maintained on every write
+        for (size_t indexCount = 0; indexCount <= INDEX_FIELDS.size(); indexCount++) {
+            if (!execSQL("DROP TABLE IF EXISTS " + benchTable + ";") || !execSQL(createTableSQL(benchTable))) {
+                return false;
+            }
+            for (size_t f = 0; f < indexCount; f++) {
+                if (!execSQL(createIndexSQL(benchTable, INDEX_FIELDS[f]))) {
+                    return false;
+                }
+            }
+
+            int successCount = 0;
+            double time = measureTime([&]() {
+                successCount = insertProducts(benchTable, NUM_DOCUMENTS);
+            });
+            recordPhaseResult("Insert " + std::to_string(indexCount) + " idx", time, successCount);
+        }
+
+        // Bulk load first, then build each index over the loaded table
+        if (!execSQL("DROP TABLE IF EXISTS " + benchTable + ";") || !execSQL(createTableSQL(benchTable))) {
+            return false;
+        }
+
+        int loaded = 0;
+        double loadTime = measureTime([&]() {
+            loaded = insertProducts(benchTable, benchmarkOptions.indexBuildDocuments);
+        });
+        recordPhaseResult("Bulk load 0 idx", loadTime, loaded);
+
+        for (const auto& field : INDEX_FIELDS) {
+            bool built = false;
+            double time = measureTime([&]() {
+                built = execSQL(createIndexSQL(benchTable, field));
+            });
+            if (built) {
+                recordPhaseResult("Build idx " + field, time, loaded);
+            }
+        }
+
+        execSQL("DROP TABLE IF EXISTS " + benchTable + ";");
+        return true;
+    }
+
+    bool runTopKTest() override {
+        if (!db) return false;
+
+        for (const std::string field : {"price", "rating"}) {
+            std::string topSQL = "SELECT id, " + documentSQL() + " FROM products ORDER BY " + fieldSQL(field) + " DESC LIMIT ?;";
+            sqlite3_stmt* topStmt;
+            if (sqlite3_prepare_v2(db, topSQL.c_str(), -1, &topStmt, nullptr) != SQLITE_OK) {
+                std::cerr << "Failed to prepare top-K statement: " << sqlite3_errmsg(db) << std::endl;
+                return false;
+            }
+
+            for (int k : TOPK_SIZES) {
+                LatencyStats latency;
+                for (int r = 0; r < TOPK_REPEATS; r++) {
+                    latency.add(measureLatency([&]() {
+                        sqlite3_reset(topStmt);
+                        sqlite3_bind_int(topStmt, 1, k);
+                        stepRows(topStmt);
+                    }));
+                }
+                recordPhaseResult("TopK " + field + " K=" + std::to_string(k), latency);
+            }
+            sqlite3_finalize(topStmt);
+        }
+
+        // OFFSET-style pagination: SQLite still walks and discards every skipped row
+        sqlite3_stmt* offsetStmt;
+        const std::string offsetSQL =
+            "SELECT id, " + documentSQL() + " FROM products ORDER BY " + fieldSQL("price") + ", id LIMIT ? OFFSET ?;";
+        if (sqlite3_prepare_v2(db, offsetSQL.c_str(), -1, &offsetStmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare offset statement: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        for (int page : PAGE_DEPTHS) {
+            LatencyStats latency;
+            for (int r = 0; r < TOPK_REPEATS; r++) {
+                latency.add(measureLatency([&]() {
+                    sqlite3_reset(offsetStmt);
+                    sqlite3_bind_int(offsetStmt, 1, PAGE_SIZE);
+                    sqlite3_bind_int(offsetStmt, 2, (page - 1) * PAGE_SIZE);
+                    stepRows(offsetStmt);
+                }));
+            }
+            recordPhaseResult("Offset page " + std::to_string(page), latency);
+        }
+        sqlite3_finalize(offsetStmt);
+
+        // Keyset pagination: seek past the previous page's last (price, id)
+        sqlite3_stmt* keysetStmt;
+        const std::string keysetSQL =
+            "SELECT id, " + documentSQL() + ", " + fieldSQL("price") + " FROM products WHERE (" + fieldSQL("price") +
+            ", id) > (?, ?) ORDER BY " + fieldSQL("price") + ", id LIMIT ?;";
+        if (sqlite3_prepare_v2(db, keysetSQL.c_str(), -1, &keysetStmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare keyset statement: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        std::vector<LatencyStats> keysetLatency(PAGE_DEPTHS.size());
+        for (int walk = 0; walk < KEYSET_WALKS; walk++) {
+            double lastPrice = std::numeric_limits<double>::lowest();
+            std::string lastId;
+            for (int page = 1; page <= PAGE_DEPTHS.back(); page++) {
+                int rows = 0;
+                double micros = measureLatency([&]() {
+                    sqlite3_reset(keysetStmt);
+                    sqlite3_bind_double(keysetStmt, 1, lastPrice);
+                    sqlite3_bind_text(keysetStmt, 2, lastId.c_str(), -1, SQLITE_TRANSIENT);
+                    sqlite3_bind_int(keysetStmt, 3, PAGE_SIZE);
+                    while (sqlite3_step(keysetStmt) == SQLITE_ROW) {
+                        lastId = reinterpret_cast<const char*>(sqlite3_column_text(keysetStmt, 0));
+                        sqlite3_column_text(keysetStmt, 1);
+                        lastPrice = sqlite3_column_double(keysetStmt, 2);
+                        rows++;
                     }
+                });
+                auto depth = std::find(PAGE_DEPTHS.begin(), PAGE_DEPTHS.end(), page);
+                if (depth != PAGE_DEPTHS.end()) {
+                    keysetLatency[depth - PAGE_DEPTHS.begin()].add(micros);
                 }
-                
-                successCount.fetch_add(threadSuccessCount);
-            });
+                if (rows == 0) break;
+            }
         }
-        
-        // Join all threads
-        for (auto& thread : threads) {
-            thread.join();
+        sqlite3_finalize(keysetStmt);
+        for (size_t d = 0; d < PAGE_DEPTHS.size(); d++) {
+            recordPhaseResult("Keyset page " + std::to_string(PAGE_DEPTHS[d]), keysetLatency[d]);
         }
-        
-        auto end = high_resolution_clock::now();
-        results.parallelTime = duration_cast<milliseconds>(end - start).count() / 1000.0;
-        results.parallelOps = successCount.load();
-        
+
         return true;
     }
-    
-private:
-    std::unique_ptr<anudb::Database> db;
-    anudb::Collection* collection = nullptr;
-};
-
-// SQLite3 test implementation
-// SQLite3 test implementation
-class SQLiteTest : public BenchmarkTest {
-public:
-    SQLiteTest() : BenchmarkTest("SQLite3") {}
 
-    bool setup() override {
-        // Remove existing database file if it exists
-        std::remove(DB_PATH_SQLITE.c_str());
+    bool runAggregationTest() override {
+        if (!db) return false;
 
-        // Open database
-        int rc = sqlite3_open(DB_PATH_SQLITE.c_str(), &db);
-        if (rc != SQLITE_OK) {
-            std::cerr << "Failed to open SQLite database: " << sqlite3_errmsg(db) << std::endl;
+        const std::string price = fieldSQL("price");
+        const std::string stock = fieldSQL("stock");
+        const std::string aggregateSQL =
+            "SELECT " + fieldSQL("category") + ", COUNT(*), SUM(" + price + "), AVG(" + price + "), SUM(" + stock +
+            "), AVG(" + stock + ") FROM products GROUP BY " + fieldSQL("category") + ";";
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, aggregateSQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare aggregate statement: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
 
-        // Enable WAL mode for better concurrency
-        char *errMsg = nullptr;
-        rc = sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, &errMsg);
-        if (rc != SQLITE_OK) {
-            std::cerr << "Failed to set WAL mode: " << errMsg << std::endl;
-            sqlite3_free(errMsg);
-            return false;
+        // GROUP BY runs fetch, extract and reduce inside the engine, so only the total is reported
+        LatencyStats totalLatency;
+        std::vector<CategoryAggregate> aggregates;
+        for (int r = 0; r < AGGREGATION_REPEATS; r++) {
+            aggregates.clear();
+            totalLatency.add(measureLatency([&]() {
+                sqlite3_reset(stmt);
+                while (sqlite3_step(stmt) == SQLITE_ROW) {
+                    CategoryAggregate aggregate;
+                    aggregate.category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+                    aggregate.count = sqlite3_column_int64(stmt, 1);
+                    aggregate.priceSum = sqlite3_column_double(stmt, 2);
+                    aggregate.priceAvg = sqlite3_column_double(stmt, 3);
+                    aggregate.stockSum = sqlite3_column_double(stmt, 4);
+                    aggregate.stockAvg = sqlite3_column_double(stmt, 5);
+                    aggregates.push_back(aggregate);
+                }
+            }));
         }
-
-        // Create products table - simplified to match AnuDB's document approach
-        const char* createTableSQL =
-            "CREATE TABLE products ("
-            "id TEXT PRIMARY KEY,"
-            "json_data TEXT,"
-            "category TEXT,"
-            "price REAL,"
-            "stock INTEGER,"
-            "rating REAL,"
-            "available INTEGER"
-            ");";
-
-        rc = sqlite3_exec(db, createTableSQL, nullptr, nullptr, &errMsg);
-        if (rc != SQLITE_OK) {
-            std::cerr << "Failed to create table: " << errMsg << std::endl;
-            sqlite3_free(errMsg);
+        sqlite3_finalize(stmt);
+        recordPhaseResult("Aggregate total", totalLatency);
+
+        // Reference: the same fields read row by row and reduced in the harness
+        std::vector<CategoryAggregate> reference;
+        const std::string rowsSQL = "SELECT " + fieldSQL("category") + ", " + price + ", " + stock + " FROM products;";
+        if (sqlite3_prepare_v2(db, rowsSQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare aggregate reference: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
-
-        // Create indexes (same as AnuDB)
-        const std::vector<std::string> indexQueries = {
-            "CREATE INDEX idx_products_category ON products(category);",
-            "CREATE INDEX idx_products_price ON products(price);",
-            "CREATE INDEX idx_products_stock ON products(stock);",
-            "CREATE INDEX idx_products_rating ON products(rating);",
-            "CREATE INDEX idx_products_available ON products(available);"
-        };
-
-        for (const auto& query : indexQueries) {
-            rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, &errMsg);
-            if (rc != SQLITE_OK) {
-                std::cerr << "Failed to create index: " << errMsg << std::endl;
-                sqlite3_free(errMsg);
-                return false;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            std::string category = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            auto expected = std::find_if(reference.begin(), reference.end(),
+                [&](const CategoryAggregate& r) { return r.category == category; });
+            if (expected == reference.end()) {
+                reference.push_back(CategoryAggregate());
+                reference.back().category = category;
+                expected = reference.end() - 1;
             }
+            expected->count++;
+            expected->priceSum += sqlite3_column_double(stmt, 1);
+            expected->stockSum += sqlite3_column_double(stmt, 2);
         }
+        sqlite3_finalize(stmt);
+        for (auto& expected : reference) {
+            expected.priceAvg = expected.priceSum / expected.count;
+            expected.stockAvg = expected.stockSum / expected.count;
+        }
+        return checkAggregates(aggregates, reference);
+    }
 
-        // Prepare statements
-        const char* insertSQL =
-            "INSERT INTO products (id, json_data, category, price, stock, rating, available) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?);";
-        rc = sqlite3_prepare_v2(db, insertSQL, -1, &insertStmt, nullptr);
+    bool runScanTest() override {
+        if (!db) return false;
 
-        if (rc != SQLITE_OK) {
-            std::cerr << "Failed to prepare insert statement: " << sqlite3_errmsg(db) << std::endl;
+        // Stream every row; only the current row is held in memory
+        sqlite3_stmt* scanStmt;
+        const std::string scanSQL = "SELECT id, " + documentSQL() + " FROM products;";
+        if (sqlite3_prepare_v2(db, scanSQL.c_str(), -1, &scanStmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare scan statement: " << sqlite3_errmsg(db) << std::endl;
             return false;
         }
+        size_t scanned = 0;
+        uint64_t scanBytes = 0;
+        double scanTime = measureTime([&]() {
+            while (sqlite3_step(scanStmt) == SQLITE_ROW) {
+                sqlite3_column_text(scanStmt, 1);
+                scanBytes += sqlite3_column_bytes(scanStmt, 1);
+                scanned++;
+            }
+        });
+        recordPhaseResult("Scan all", scanTime, scanned, scanBytes);
+
+        // Export: stream rows straight into a JSON-lines file
+        const std::string exportFile = EXPORT_PATH + ".jsonl";
+        sqlite3_reset(scanStmt);
+        size_t exported = 0;
+        double exportTime = measureTime([&]() {
+            std::ofstream out(exportFile.c_str(), std::ios::trunc);
+            while (sqlite3_step(scanStmt) == SQLITE_ROW) {
+                out.write(reinterpret_cast<const char*>(sqlite3_column_text(scanStmt, 1)), sqlite3_column_bytes(scanStmt, 1));
+                out.put('\n');
+                exported++;
+            }
+        });
+        sqlite3_finalize(scanStmt);
+        recordPhaseResult("Export JSON", exportTime, exported, pathSizeBytes(exportFile));
+        std::remove(exportFile.c_str());
+
+        // Streaming import: one JSON line is parsed and inserted at a time
+        const std::string importTable = "products_import";
+        uint64_t importBytes = writeImportFile(IMPORT_FILE_PATH, NUM_DOCUMENTS);
+        if (!execSQL("DROP TABLE IF EXISTS " + importTable + ";") || !execSQL(createTableSQL(importTable))) {
+            return false;
+        }
+        sqlite3_stmt* importStmt;
+        if (sqlite3_prepare_v2(db, insertSQL(importTable).c_str(), -1, &importStmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare import statement: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        int imported = 0;
+        double importTime = measureTime([&]() {
+            std::ifstream in(IMPORT_FILE_PATH.c_str());
+            std::string line;
+            execSQL("BEGIN TRANSACTION;");
+            while (std::getline(in, line)) {
+                json productData = json::parse(line);
+                sqlite3_reset(importStmt);
+                bindProduct(importStmt, productData["id"].get_ref<const std::string&>(), line, productData);
+                if (sqlite3_step(importStmt) == SQLITE_DONE) {
+                    imported++;
+                }
+            }
+            execSQL("COMMIT;");
+        });
+        sqlite3_finalize(importStmt);
+        recordPhaseResult("Import JSON-lines", importTime, imported, importBytes);
+        execSQL("DROP TABLE IF EXISTS " + importTable + ";");
+        std::remove(IMPORT_FILE_PATH.c_str());
+
+        // Optional partitioned scan: each thread reads one slice of the price range on its own connection
+        if (benchmarkOptions.scanThreads > 0) {
+            int partitions = benchmarkOptions.scanThreads;
+            std::atomic<size_t> partitionDocs(0);
+            std::atomic<uint64_t> partitionBytes(0);
+            std::vector<std::thread> threads;
+            double parallelTime = measureTime([&]() {
+                for (int t = 0; t < partitions; t++) {
+                    threads.emplace_back([&, t]() {
+                        sqlite3* threadDb;
+                        if (sqlite3_open(DB_PATH_SQLITE.c_str(), &threadDb) != SQLITE_OK) {
+                            std::cerr << "Scan thread " << t << " failed to open database" << std::endl;
+                            sqlite3_close(threadDb);
+                            return;
+                        }
+                        configureConnection(threadDb);
+                        double low, high;
+                        scanPartition(t, partitions, low, high);
+                        sqlite3_stmt* stmt;
+                        const std::string partitionSQL = "SELECT id, " + documentSQL() + " FROM products WHERE " +
+                            fieldSQL("price") + " > ? AND " + fieldSQL("price") + " < ?;";
+                        if (sqlite3_prepare_v2(threadDb, partitionSQL.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                            sqlite3_bind_double(stmt, 1, low);
+                            sqlite3_bind_double(stmt, 2, high);
+                            size_t count = 0;
+                            uint64_t bytes = 0;
+                            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                                bytes += sqlite3_column_bytes(stmt, 1);
+                                count++;
+                            }
+                            sqlite3_finalize(stmt);
+                            partitionDocs.fetch_add(count);
+                            partitionBytes.fetch_add(bytes);
+                        }
+                        sqlite3_close(threadDb);
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+            });
+            recordPhaseResult("Parallel scan " + std::to_string(partitions) + " thr", parallelTime,
+                              partitionDocs.load(), partitionBytes.load());
+        }
 
         return true;
     }
 
-    bool cleanup() override {
-        if (insertStmt) {
-            sqlite3_finalize(insertStmt);
-            insertStmt = nullptr;
-        }
+    uint64_t footprintBytes() override {
+        return pathSizeBytes(DB_PATH_SQLITE) + pathSizeBytes(DB_PATH_SQLITE + "-wal");
+    }
 
-        if (db) {
-            sqlite3_close(db);
-            db = nullptr;
+    bool runPartialUpdateTest() override {
+        if (!db) return false;
+
+        const std::string partialTable = "products_partial";
+        const std::vector<int> targets = partialUpdateTargets();
+        for (const auto& docSize : PARTIAL_UPDATE_SIZES) {
+            if (!execSQL("DROP TABLE IF EXISTS " + partialTable + ";") || !execSQL(createTableSQL(partialTable))) {
+                return false;
+            }
+            sqlite3_stmt* insert;
+            if (sqlite3_prepare_v2(db, insertSQL(partialTable).c_str(), -1, &insert, nullptr) != SQLITE_OK) {
+                std::cerr << "Failed to prepare insert statement: " << sqlite3_errmsg(db) << std::endl;
+                return false;
+            }
+            execSQL("BEGIN TRANSACTION;");
+            for (int i = 0; i < PARTIAL_UPDATE_DOCUMENTS; i++) {
+                json productData = generatePartialUpdateProduct(i, docSize);
+                std::string docId = makeDocId("prod", i);
+                std::string jsonStr = productData.dump();
+                sqlite3_reset(insert);
+                bindProduct(insert, docId, jsonStr, productData);
+                sqlite3_step(insert);
+            }
+            execSQL("COMMIT;");
+            sqlite3_finalize(insert);
+
+            for (const auto& op : PARTIAL_UPDATE_OPERATORS) {
+                // One UPDATE that edits the stored document with the SQLite JSON functions
+                sqlite3_stmt* partial;
+                std::string sql = partialUpdateSQL(partialTable, op);
+                if (sqlite3_prepare_v2(db, sql.c_str(), -1, &partial, nullptr) != SQLITE_OK) {
+                    std::cerr << "Failed to prepare partial update (" << sql << "): " << sqlite3_errmsg(db) << std::endl;
+                    return false;
+                }
+                LatencyStats latency;
+                for (size_t r = 0; r < targets.size(); r++) {
+                    std::string docId = makeDocId("prod", targets[r]);
+                    latency.add(measureLatency([&]() {
+                        sqlite3_reset(partial);
+                        bindPartialUpdate(partial, op, r);
+                        sqlite3_bind_text(partial, 2, docId.c_str(), -1, SQLITE_TRANSIENT);
+                        sqlite3_step(partial);
+                    }));
+                }
+                sqlite3_finalize(partial);
+                // SQLite writes the full row back, so every update rewrites the whole stored document
+                recordPartialUpdate("Partial " + docSize + " " + op, latency, documentBytes(partialTable, targets), 0);
+
+                // Read-modify-write: SELECT, parse, change it here, dump and UPDATE
+                sqlite3_stmt* select;
+                sqlite3_stmt* update;
+                std::string selectSQL = "SELECT " + documentSQL() + " FROM " + partialTable + " WHERE id = ?;";
+                if (sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &select, nullptr) != SQLITE_OK ||
+                    sqlite3_prepare_v2(db, updateSQL(partialTable).c_str(), -1, &update, nullptr) != SQLITE_OK) {
+                    std::cerr << "Failed to prepare read-modify-write statements: " << sqlite3_errmsg(db) << std::endl;
+                    return false;
+                }
+                latency = LatencyStats();
+                uint64_t clientBytes = 0;
+                for (size_t r = 0; r < targets.size(); r++) {
+                    std::string docId = makeDocId("prod", targets[r]);
+                    latency.add(measureLatency([&]() {
+                        sqlite3_reset(select);
+                        sqlite3_bind_text(select, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+                        if (sqlite3_step(select) == SQLITE_ROW) {
+                            std::string stored(reinterpret_cast<const char*>(sqlite3_column_text(select, 0)));
+                            json product = json::parse(stored);
+                            applyPartialUpdate(product, op, r);
+                            std::string updated = product.dump();
+                            sqlite3_reset(update);
+                            bindUpdate(update, updated, product["price"].get<double>(), product["stock"].get<int>(), docId);
+                            sqlite3_step(update);
+                            clientBytes += stored.size() + updated.size();
+                        }
+                    }));
+                }
+                sqlite3_finalize(select);
+                sqlite3_finalize(update);
+                recordPartialUpdate("RMW " + docSize + " " + op, latency, documentBytes(partialTable, targets), clientBytes);
+            }
         }
 
+        execSQL("DROP TABLE IF EXISTS " + partialTable + ";");
         return true;
     }
 
-    bool runInsertTest() override {
-        if (!db || !insertStmt) return false;
+    bool runTombstoneTest() override {
+        if (!db) return false;
 
-        int successCount = 0;
-        results.insertTime = measureTime([&]() {
-            // Begin transaction for bulk insert
-            char* errMsg = nullptr;
-            int rc = sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
-            if (rc != SQLITE_OK) {
-                std::cerr << "Failed to begin transaction: " << errMsg << std::endl;
-                sqlite3_free(errMsg);
-                return;
+        const std::string tombstoneTable = "products_tombstone";
+        for (int fraction : DELETE_FRACTIONS) {
+            const std::string suffix = " " + std::to_string(fraction) + "%";
+            if (!execSQL("DROP TABLE IF EXISTS " + tombstoneTable + ";") || !execSQL(createTableSQL(tombstoneTable)) ||
+                !execSQL(createIndexSQL(tombstoneTable, "price"))) {
+                return false;
+            }
+            insertProducts(tombstoneTable, TOMBSTONE_DOCUMENTS);
+            execSQL("PRAGMA wal_checkpoint(TRUNCATE);");
+
+            // Delete the oldest documents, lowest index first, in one transaction
+            int deleted = TOMBSTONE_DOCUMENTS * fraction / 100;
+            int deleteCount = 0;
+            sqlite3_stmt* stmt;
+            std::string deleteSQL = "DELETE FROM " + tombstoneTable + " WHERE id = ?;";
+            if (sqlite3_prepare_v2(db, deleteSQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                std::cerr << "Failed to prepare delete statement: " << sqlite3_errmsg(db) << std::endl;
+                return false;
             }
+            double deleteTime = measureTime([&]() {
+                execSQL("BEGIN TRANSACTION;");
+                for (int i = 0; i < deleted; i++) {
+                    std::string docId = makeDocId("prod", i);
+                    sqlite3_reset(stmt);
+                    sqlite3_bind_text(stmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+                    if (sqlite3_step(stmt) == SQLITE_DONE && sqlite3_changes(db) > 0) {
+                        deleteCount++;
+                    }
+                }
+                execSQL("COMMIT;");
+            });
+            sqlite3_finalize(stmt);
+            recordPhaseResult("Delete" + suffix, deleteTime, deleteCount);
+            execSQL("PRAGMA wal_checkpoint(TRUNCATE);");
+            uint64_t deletedBytes = footprintBytes();
+            timeTombstoneReads(tombstoneTable, deleted, suffix);
+
+            // VACUUM rebuilds the whole database file, returning freelist pages to the OS
+            bool vacuumed = false;
+            double vacuumTime = measureTime([&]() {
+                vacuumed = execSQL("VACUUM;");
+            });
+            if (!vacuumed) return false;
+            recordPhaseResult("Compact" + suffix, vacuumTime, TOMBSTONE_DOCUMENTS - deleteCount);
+            execSQL("PRAGMA wal_checkpoint(TRUNCATE);");
+            std::cout << "    SQLite3" << suffix << " deleted: " << std::fixed << std::setprecision(2)
+                      << deletedBytes / (1024.0 * 1024.0) << " MB after deletes, "
+                      << footprintBytes() / (1024.0 * 1024.0) << " MB after VACUUM" << std::endl;
+            timeTombstoneReads(tombstoneTable, deleted, suffix + " compacted");
+        }
 
-            for (int i = 0; i < NUM_DOCUMENTS; i++) {
-                json productData = generateRandomProduct(i);
-                std::string docId = "prod" + std::to_string(i);
-                std::string jsonStr = productData.dump();
+        execSQL("DROP TABLE IF EXISTS " + tombstoneTable + ";");
+        return true;
+    }
 
-                // Bind parameters - now focusing on storing the whole JSON document
-                sqlite3_reset(insertStmt);
-                sqlite3_bind_text(insertStmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
-                sqlite3_bind_text(insertStmt, 2, jsonStr.c_str(), -1, SQLITE_TRANSIENT);
-                
-                // Extract indexed fields from the JSON to maintain parity with AnuDB's indexing
-                sqlite3_bind_text(insertStmt, 3, productData["category"].get<std::string>().c_str(), -1, SQLITE_TRANSIENT);
-                sqlite3_bind_double(insertStmt, 4, productData["price"].get<double>());
-                sqlite3_bind_int(insertStmt, 5, productData["stock"].get<int>());
-                sqlite3_bind_double(insertStmt, 6, productData["rating"].get<double>());
-                sqlite3_bind_int(insertStmt, 7, productData["available"].get<bool>() ? 1 : 0);
+    bool runTimeSeriesTest() override {
+        if (!db) return false;
 
-                rc = sqlite3_step(insertStmt);
-                if (rc == SQLITE_DONE) {
-                    successCount++;
+        // Readings keep ts in its own indexed column whatever --sqlite-schema is
+        if (!execSQL("DROP TABLE IF EXISTS readings;") ||
+            !execSQL("CREATE TABLE readings (id TEXT PRIMARY KEY, json_data TEXT, ts INTEGER);") ||
+            !execSQL("CREATE INDEX idx_readings_ts ON readings(ts);")) {
+            return false;
+        }
+        sqlite3_stmt* insert;
+        if (sqlite3_prepare_v2(db, "INSERT INTO readings (id, json_data, ts) VALUES (?, ?, ?);", -1, &insert, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare reading insert: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        // The writer, query and expiry connections contend for the database, so wait on locks
+        sqlite3_busy_timeout(db, 5000);
+
+        std::atomic<bool> running(true);
+        LatencyStats queryLatency;
+        std::thread queryThread([&]() {
+            sqlite3* threadDb;
+            sqlite3_stmt* stmt;
+            if (sqlite3_open(DB_PATH_SQLITE.c_str(), &threadDb) != SQLITE_OK) return;
+            sqlite3_busy_timeout(threadDb, 5000);
+            configureConnection(threadDb);
+            if (sqlite3_prepare_v2(threadDb, "SELECT id, json_data FROM readings WHERE ts > ?;", -1, &stmt, nullptr) == SQLITE_OK) {
+                while (running.load()) {
+                    int64_t from = nowMillis() - benchmarkOptions.tsWindow * 1000LL;
+                    queryLatency.add(measureLatency([&]() {
+                        sqlite3_reset(stmt);
+                        sqlite3_bind_int64(stmt, 1, from);
+                        stepRows(stmt);
+                    }));
+                    std::this_thread::sleep_for(std::chrono::milliseconds(TS_QUERY_INTERVAL_MS));
                 }
+                sqlite3_finalize(stmt);
             }
+            sqlite3_close(threadDb);
+        });
 
-            // Commit transaction
-            rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg);
-            if (rc != SQLITE_OK) {
-                std::cerr << "Failed to commit transaction: " << errMsg << std::endl;
-                sqlite3_free(errMsg);
+        // Expiry: one DELETE of everything older than the retention period
+        LatencyStats expiryLatency;
+        size_t expired = 0;
+        uint64_t peakBytes = 0;
+        std::thread expiryThread([&]() {
+            sqlite3* threadDb;
+            sqlite3_stmt* stmt;
+            if (sqlite3_open(DB_PATH_SQLITE.c_str(), &threadDb) != SQLITE_OK) return;
+            sqlite3_busy_timeout(threadDb, 5000);
+            configureConnection(threadDb);
+            if (sqlite3_prepare_v2(threadDb, "DELETE FROM readings WHERE ts < ?;", -1, &stmt, nullptr) == SQLITE_OK) {
+                while (running.load()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(TS_EXPIRY_INTERVAL_MS));
+                    int64_t cutoff = nowMillis() - benchmarkOptions.tsRetention * 1000LL;
+                    expiryLatency.add(measureLatency([&]() {
+                        sqlite3_reset(stmt);
+                        sqlite3_bind_int64(stmt, 1, cutoff);
+                        if (sqlite3_step(stmt) == SQLITE_DONE) {
+                            expired += sqlite3_changes(threadDb);
+                        }
+                    }));
+                    peakBytes = std::max(peakBytes, footprintBytes());
+                }
+                sqlite3_finalize(stmt);
             }
+            sqlite3_close(threadDb);
         });
 
-        results.insertOps = successCount;
+        LatencyStats appendLatency;
+        uint64_t appendBytes = 0;
+        size_t appended = 0;
+        double ingestTime = measureTime([&]() {
+            appended = paceAppends([&](size_t seq, int64_t tsMs) {
+                json reading = generateReading(seq, tsMs);
+                std::string docId = reading["id"].get<std::string>();
+                std::string jsonStr = reading.dump();
+                appendBytes += jsonStr.size();
+                appendLatency.add(measureLatency([&]() {
+                    sqlite3_reset(insert);
+                    sqlite3_bind_text(insert, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+                    sqlite3_bind_text(insert, 2, jsonStr.c_str(), -1, SQLITE_TRANSIENT);
+                    sqlite3_bind_int64(insert, 3, tsMs);
+                    sqlite3_step(insert);
+                }));
+            });
+        });
+        running = false;
+        queryThread.join();
+        expiryThread.join();
+        sqlite3_finalize(insert);
+        // Keep the lock wait configureConnection set up for the background checkpointer
+        if (!backgroundCheckpoint()) {
+            sqlite3_busy_timeout(db, 0);
+        }
+
+        recordPhaseResult("TS ingest", ingestTime, appended, appendBytes);
+        recordPhaseResult("TS append", appendLatency);
+        recordPhaseResult("TS window query", queryLatency);
+        recordPhaseResult("TS expiry pass", expiryLatency);
+        reportTimeSeries(appended, ingestTime, expired, peakBytes, footprintBytes());
+
+        execSQL("DROP TABLE IF EXISTS readings;");
         return true;
     }
 
-    bool runQueryTest() override {
+    bool runSoakTest() override {
         if (!db) return false;
 
-        int successCount = 0;
-        std::vector<std::string> queries = {
-            // By category
-            "SELECT id, json_data FROM products WHERE category = 'Electronics';",
-            "SELECT id, json_data FROM products WHERE category = 'Books';",
-            "SELECT id, json_data FROM products WHERE category = 'Food';",
-            "SELECT id, json_data FROM products WHERE category = 'Clothing';",
+        const std::string soakTable = "products_soak";
+        if (!execSQL("DROP TABLE IF EXISTS " + soakTable + ";") || !execSQL(createTableSQL(soakTable)) ||
+            !execSQL(createIndexSQL(soakTable, "price"))) {
+            return false;
+        }
+        insertProducts(soakTable, NUM_DOCUMENTS);
+
+        // One prepared statement per SoakOp, in enum order
+        const std::string price = fieldSQL("price");
+        const std::vector<std::string> soakSQL = {
+            "SELECT id, " + documentSQL() + " FROM " + soakTable + " WHERE id = ?1;",
+            insertSQL(soakTable),
+            partialUpdateSQL(soakTable, "$set"),
+            "DELETE FROM " + soakTable + " WHERE id = ?1;",
+            "SELECT id, " + documentSQL() + " FROM " + soakTable + " WHERE " + price + " > ?1 AND " + price + " < ?1 + 2.0;"
+        };
+        std::vector<sqlite3_stmt*> stmts;
+        for (const auto& sql : soakSQL) {
+            sqlite3_stmt* stmt;
+            if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                std::cerr << "Failed to prepare soak statement (" << sql << "): " << sqlite3_errmsg(db) << std::endl;
+                for (auto prepared : stmts) sqlite3_finalize(prepared);
+                return false;
+            }
+            stmts.push_back(stmt);
+        }
 
-            // By price range
-            "SELECT id, json_data FROM products WHERE price > 500.0;",
-            "SELECT id, json_data FROM products WHERE price < 100.0;",
-            "SELECT id, json_data FROM products WHERE price > 100.0 AND price < 500.0;",
+        bool completed = soakLoop(NUM_DOCUMENTS, [&](SoakOp op, int index, const json& product) {
+            std::string docId = makeDocId("prod", index);
+            std::string jsonStr = op == SOAK_INSERT ? product.dump() : std::string();
+            sqlite3_stmt* stmt = stmts[op];
+            sqlite3_reset(stmt);
+            switch (op) {
+                case SOAK_INSERT:
+                    bindProduct(stmt, docId, jsonStr, product);
+                    break;
+                case SOAK_UPDATE:
+                    bindPartialUpdate(stmt, "$set", index);
+                    sqlite3_bind_text(stmt, 2, docId.c_str(), -1, SQLITE_TRANSIENT);
+                    break;
+                case SOAK_QUERY:
+                    sqlite3_bind_double(stmt, 1, partialUpdatePrice(index));
+                    break;
+                default:
+                    sqlite3_bind_text(stmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+                    break;
+            }
+            stepRows(stmt);
+        });
 
-            // By rating
-            "SELECT id, json_data FROM products WHERE rating > 4.0;",
+        for (auto stmt : stmts) {
+            sqlite3_finalize(stmt);
+        }
+        execSQL("DROP TABLE IF EXISTS " + soakTable + ";");
+        return completed;
+    }
 
-            // By availability
-            "SELECT id, json_data FROM products WHERE available = 1;",
+    bool runInterferenceTest() override {
+        if (!db) return false;
 
-            // Combined queries
-            "SELECT id, json_data FROM products WHERE category = 'Electronics' AND price > 1000.0;"
+        const std::string rwTable = "products_rw";
+        if (!execSQL("DROP TABLE IF EXISTS " + rwTable + ";") || !execSQL(createTableSQL(rwTable)) ||
+            !execSQL(createIndexSQL(rwTable, "price"))) {
+            return false;
+        }
+        insertProducts(rwTable, NUM_DOCUMENTS);
+
+        // Every reader and writer thread gets its own connection, so WAL readers never wait on
+        // the writer; writers queue on the write lock through the busy timeout
+        const std::string price = fieldSQL("price");
+        const std::vector<std::string> threadSQL = {
+            "SELECT id, " + documentSQL() + " FROM " + rwTable + " WHERE id = ?1;",
+            "SELECT id, " + documentSQL() + " FROM " + rwTable + " WHERE " + price + " > ?1 AND " + price + " < ?1 + 2.0;",
+            insertSQL(rwTable),
+            partialUpdateSQL(rwTable, "patch")
         };
-
-        results.queryTime = measureTime([&]() {
-            for (int i = 0; i < NUM_QUERIES; i++) {
-                const std::string& query = queries[i % queries.size()];
-
-                sqlite3_stmt* stmt;
-                int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
-
-                if (rc == SQLITE_OK) {
-                    int count = 0;
-                    while (sqlite3_step(stmt) == SQLITE_ROW) {
-                        // The document data is in the second column (index 1)
-                        const char* jsonData = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-                        // Parse the JSON to simulate what AnuDB would do with the returned document
-                        //json doc = json::parse(jsonData);
-                        count++;
+        struct ThreadConnection {
+            sqlite3* db;
+            std::vector<sqlite3_stmt*> stmts;
+        };
+        std::vector<ThreadConnection> readers(benchmarkOptions.rwReaders);
+        std::vector<ThreadConnection> writers(benchmarkOptions.rwWriters);
+        bool prepared = true;
+        for (auto* group : {&readers, &writers}) {
+            for (auto& connection : *group) {
+                connection.db = nullptr;
+                if (sqlite3_open(DB_PATH_SQLITE.c_str(), &connection.db) != SQLITE_OK) {
+                    prepared = false;
+                    continue;
+                }
+                sqlite3_busy_timeout(connection.db, 5000);
+                configureConnection(connection.db);
+                for (const auto& sql : threadSQL) {
+                    sqlite3_stmt* stmt = nullptr;
+                    if (sqlite3_prepare_v2(connection.db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                        std::cerr << "Failed to prepare interference statement (" << sql << "): "
+                                  << sqlite3_errmsg(connection.db) << std::endl;
+                        prepared = false;
                     }
+                    connection.stmts.push_back(stmt);
+                }
+            }
+        }
 
-                    if (count > 0) {
-                        successCount++;
+        if (prepared) {
+            interferenceLoop(
+                [&](int thread, bool range, int index) {
+                    sqlite3_stmt* stmt = readers[thread].stmts[range ? 1 : 0];
+                    sqlite3_reset(stmt);
+                    if (range) {
+                        sqlite3_bind_double(stmt, 1, partialUpdatePrice(index));
+                    } else {
+                        std::string docId = makeDocId("prod", index);
+                        sqlite3_bind_text(stmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
                     }
-                }
+                    stepRows(stmt);
+                },
+                [&](int thread, bool insert, const std::string& docId, const json& product) {
+                    sqlite3_stmt* stmt = writers[thread].stmts[insert ? 2 : 3];
+                    std::string jsonStr = insert ? product.dump()
+                                                 : json({{"price", product["price"]}, {"stock", product["stock"]}}).dump();
+                    sqlite3_reset(stmt);
+                    if (insert) {
+                        bindProduct(stmt, docId, jsonStr, product);
+                    } else {
+                        sqlite3_bind_text(stmt, 1, jsonStr.c_str(), -1, SQLITE_TRANSIENT);
+                        sqlite3_bind_text(stmt, 2, docId.c_str(), -1, SQLITE_TRANSIENT);
+                    }
+                    sqlite3_step(stmt);
+                });
+        }
 
-                sqlite3_finalize(stmt);
+        for (auto* group : {&readers, &writers}) {
+            for (auto& connection : *group) {
+                for (auto stmt : connection.stmts) sqlite3_finalize(stmt);
+                sqlite3_close(connection.db);
             }
-        });
+        }
+        execSQL("DROP TABLE IF EXISTS " + rwTable + ";");
+        return prepared;
+    }
 
-        results.queryOps = NUM_QUERIES;
+    bool runCheckpointTest() override {
+        if (!db) return false;
+
+        const std::string walTable = "products_wal";
+        if (!execSQL("DROP TABLE IF EXISTS " + walTable + ";") || !execSQL(createTableSQL(walTable))) {
+            return false;
+        }
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, insertSQL(walTable).c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare insert statement: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        std::cout << "    SQLite3 checkpoint strategy: " << benchmarkOptions.sqliteCheckpoint << std::endl;
+
+        // Each write commits on its own so checkpoint work lands between the timed writes
+        walWriteLoop(
+            [&](int index, const json& product) {
+                std::string docId = makeDocId("prod", index);
+                std::string jsonStr = product.dump();
+                sqlite3_reset(stmt);
+                bindProduct(stmt, docId, jsonStr, product);
+                sqlite3_step(stmt);
+            },
+            [&]() { return pathSizeBytes(DB_PATH_SQLITE + "-wal"); });
+        sqlite3_finalize(stmt);
+
+        std::lock_guard<std::mutex> lock(checkpointMutex);
+        if (checkpointLatency.count() > 0) {
+            recordPhaseResult("Background checkpoint", checkpointLatency);
+            std::cout << "    SQLite3 background checkpoints: " << checkpointLatency.count() << " run, "
+                      << checkpointBusy << " returned SQLITE_BUSY" << std::endl;
+        }
+        execSQL("DROP TABLE IF EXISTS " + walTable + ";");
         return true;
     }
 
-    bool runUpdateTest() override {
+    bool runColdStartTest() override {
         if (!db) return false;
 
-        int successCount = 0;
-        results.updateTime = measureTime([&]() {
-            // Begin transaction for bulk update
-            char* errMsg = nullptr;
-            int rc = sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
-            if (rc != SQLITE_OK) {
-                std::cerr << "Failed to begin transaction: " << errMsg << std::endl;
-                sqlite3_free(errMsg);
-                return;
-            }
-
-            for (int i = 0; i < NUM_DOCUMENTS / 2; i++) {
-                std::string docId = "prod" + std::to_string(i);
-                double newPrice = 100.0 + (i % 10) * 50.0;
-                int newStock = 10 + (i % 20);
+        // The cold store is a second database file so the main connection stays open
+        const std::string coldPath = DB_PATH_SQLITE + "_cold";
+        const std::vector<std::string> coldFiles = {coldPath, coldPath + "-wal", coldPath + "-shm"};
+        const std::string price = fieldSQL("price");
+        const std::string readSQL = "SELECT id, " + documentSQL() + " FROM products WHERE id = ?1;";
+        const std::string querySQL = "SELECT id, " + documentSQL() + " FROM products WHERE " + price +
+                                     " > ?1 AND " + price + " < ?1 + 2.0;";
+        sqlite3* coldDb = nullptr;
+        sqlite3_stmt* readStmt = nullptr;
+        sqlite3_stmt* queryStmt = nullptr;
+        auto closeCold = [&]() {
+            sqlite3_finalize(readStmt);
+            sqlite3_finalize(queryStmt);
+            sqlite3_close(coldDb);
+            coldDb = nullptr;
+            readStmt = queryStmt = nullptr;
+        };
 
-                // First, fetch the existing JSON document
-                std::string selectSQL = "SELECT json_data FROM products WHERE id = ?;";
-                sqlite3_stmt* selectStmt;
-                rc = sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &selectStmt, nullptr);
+        bool completed = coldStartLoop(coldFiles,
+            [&](int size) {
+                removeDatabaseFiles(coldPath);
+                if (sqlite3_open(coldPath.c_str(), &coldDb) != SQLITE_OK) {
+                    closeCold();
+                    return false;
+                }
+                configureConnection(coldDb);
+                // Leave the WAL behind on close, as a power cut would, so the reopen has to
+                // rebuild the wal-index from it before the first read
+                sqlite3_db_config(coldDb, SQLITE_DBCONFIG_NO_CKPT_ON_CLOSE, 1, nullptr);
+                bool loaded = execSQL(coldDb, "PRAGMA journal_mode=WAL;") &&
+                              execSQL(coldDb, createTableSQL("products")) &&
+                              execSQL(coldDb, createIndexSQL("products", "price")) &&
+                              insertProducts(coldDb, "products", size) == size;
+                closeCold();
+                return loaded;
+            },
+            [&]() { return pathSizeBytes(coldPath + "-wal"); },
+            [&]() {
+                // sqlite3_open reads nothing; preparing the statements loads the schema and runs
+                // WAL recovery, so both sit inside the timed reopen
+                if (sqlite3_open(coldPath.c_str(), &coldDb) != SQLITE_OK) return false;
+                configureConnection(coldDb);
+                return sqlite3_prepare_v2(coldDb, readSQL.c_str(), -1, &readStmt, nullptr) == SQLITE_OK &&
+                       sqlite3_prepare_v2(coldDb, querySQL.c_str(), -1, &queryStmt, nullptr) == SQLITE_OK;
+            },
+            [&](int index) {
+                std::string docId = makeDocId("prod", index);
+                sqlite3_reset(readStmt);
+                sqlite3_bind_text(readStmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+                stepRows(readStmt);
+            },
+            [&](int index) {
+                sqlite3_reset(queryStmt);
+                sqlite3_bind_double(queryStmt, 1, partialUpdatePrice(index));
+                stepRows(queryStmt);
+            },
+            closeCold);
+        removeDatabaseFiles(coldPath);
+        return completed;
+    }
 
-                if (rc == SQLITE_OK) {
-                    sqlite3_bind_text(selectStmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+    bool runCrashTest() override {
+        if (!db) return false;
 
-                    if (sqlite3_step(selectStmt) == SQLITE_ROW) {
-                        // Get the JSON data
-                        const char* jsonStr = reinterpret_cast<const char*>(sqlite3_column_text(selectStmt, 0));
-                        json productData = json::parse(jsonStr);
+        const std::string crashPath = DB_PATH_SQLITE + "_crash";
+        const std::string readSQL = "SELECT id, " + documentSQL() + " FROM products WHERE id = ?1;";
+        sqlite3* crashDb = nullptr;
+        sqlite3_stmt* readStmt = nullptr;
+        auto readProduct = [&](int index) {
+            std::string docId = makeDocId("prod", index);
+            sqlite3_reset(readStmt);
+            sqlite3_bind_text(readStmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+            return stepRows(readStmt) > 0;
+        };
+        bool completed = crashLoop(SQLITE_CRASH_SETTINGS,
+            [&]() { return pathSizeBytes(crashPath + "-wal"); },
+            [&](int lastAcked) {
+                // The first statement prepared runs WAL recovery over whatever the writer left
+                if (sqlite3_open(crashPath.c_str(), &crashDb) != SQLITE_OK ||
+                    sqlite3_prepare_v2(crashDb, readSQL.c_str(), -1, &readStmt, nullptr) != SQLITE_OK) {
+                    return false;
+                }
+                readProduct(lastAcked);
+                return true;
+            },
+            readProduct,
+            [&]() {
+                sqlite3_finalize(readStmt);
+                sqlite3_close(crashDb);
+                readStmt = nullptr;
+                crashDb = nullptr;
+            });
+        removeDatabaseFiles(crashPath);
+        return completed;
+    }
 
-                        // Update the JSON data
-                        productData["price"] = newPrice;
-                        productData["stock"] = newStock;
-                        productData["updated_at"] = getCurrentTimeString();
+    bool runCrashWriter(const std::string& setting, int ackFd) override {
+        const std::string crashPath = DB_PATH_SQLITE + "_crash";
+        removeDatabaseFiles(crashPath);
+        sqlite3* crashDb = nullptr;
+        sqlite3_stmt* stmt = nullptr;
+        // Each insert commits on its own under SQLite's default autocheckpoint
+        bool ok = sqlite3_open(crashPath.c_str(), &crashDb) == SQLITE_OK &&
+                  execSQL(crashDb, "PRAGMA journal_mode=WAL;") &&
+                  execSQL(crashDb, "PRAGMA " + setting + ";") &&
+                  execSQL(crashDb, createTableSQL("products")) &&
+                  execSQL(crashDb, createIndexSQL("products", "price")) &&
+                  sqlite3_prepare_v2(crashDb, insertSQL("products").c_str(), -1, &stmt, nullptr) == SQLITE_OK;
+        for (int i = 0; ok && i < CRASH_MAX_WRITES; i++) {
+            json productData = generateRandomProduct(i);
+            std::string docId = makeDocId("prod", i);
+            std::string jsonStr = productData.dump();
+            sqlite3_reset(stmt);
+            bindProduct(stmt, docId, jsonStr, productData);
+            ok = sqlite3_step(stmt) == SQLITE_DONE && acknowledgeWrite(ackFd, i);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(crashDb);
+        return ok;
+    }
 
-                        // Now update the database - update both the JSON document and the indexed fields
-                        std::string updateSQL =
-                            "UPDATE products SET json_data = ?, price = ?, stock = ? WHERE id = ?;";
-                        sqlite3_stmt* updateStmt;
-                        rc = sqlite3_prepare_v2(db, updateSQL.c_str(), -1, &updateStmt, nullptr);
+    bool runBuilderTest() override {
+        if (!db) return false;
 
-                        if (rc == SQLITE_OK) {
-                            std::string updatedJsonStr = productData.dump();
+        // Each insert run is one transaction into a fresh scratch table
+        sqlite3_stmt* stmt = nullptr;
+        return builderLoop(
+            [&]() {
+                return execSQL("DROP TABLE IF EXISTS products_builder;") &&
+                       execSQL(createTableSQL("products_builder")) &&
+                       execSQL(createIndexSQL("products_builder", "price")) &&
+                       sqlite3_prepare_v2(db, insertSQL("products_builder").c_str(), -1, &stmt, nullptr) == SQLITE_OK &&
+                       execSQL("BEGIN TRANSACTION;");
+            },
+            [&](int, const std::string& docId, const std::string& jsonStr, const json& product) {
+                sqlite3_reset(stmt);
+                bindProduct(stmt, docId, jsonStr, product);
+                return sqlite3_step(stmt) == SQLITE_DONE;
+            },
+            [&](int, const FlatProduct& flat) {
+                sqlite3_reset(stmt);
+                bindFlatProduct(stmt, flat);
+                return sqlite3_step(stmt) == SQLITE_DONE;
+            },
+            [&]() {
+                bool committed = execSQL("COMMIT;");
+                sqlite3_finalize(stmt);
+                stmt = nullptr;
+                return execSQL("DROP TABLE IF EXISTS products_builder;") && committed;
+            });
+    }
 
-                            sqlite3_bind_text(updateStmt, 1, updatedJsonStr.c_str(), -1, SQLITE_TRANSIENT);
-                            sqlite3_bind_double(updateStmt, 2, newPrice);
-                            sqlite3_bind_int(updateStmt, 3, newStock);
-                            sqlite3_bind_text(updateStmt, 4, docId.c_str(), -1, SQLITE_TRANSIENT);
+    bool runEncodingTest() override {
+        if (!db) return false;
 
-                            rc = sqlite3_step(updateStmt);
-                            if (rc == SQLITE_DONE) {
-                                successCount++;
-                            }
+        // The same products, built once, are stored under each encoding in a scratch table
+        // with the price and category copied out, so queries filter without decoding
+        std::vector<json> products;
+        products.reserve(NUM_DOCUMENTS);
+        for (int i = 0; i < NUM_DOCUMENTS; i++) {
+            products.push_back(generateRandomProduct(i));
+        }
+        std::mt19937 gen(19);
+        std::uniform_real_distribution<> low_dist(10.0, 2000.0 - ENCODING_QUERY_WIDTH);
+        std::vector<double> lows(NUM_QUERIES);
+        for (auto& low : lows) {
+            low = low_dist(gen);
+        }
 
-                            sqlite3_finalize(updateStmt);
-                        }
-                    }
+        // JSON text size is the baseline every encoding is compared with, whether or not
+        // --encodings lists json
+        size_t jsonBytes = 0;
+        std::string jsonText;
+        for (const auto& product : products) {
+            encodeDocument(product, "json", jsonText);
+            jsonBytes += jsonText.size();
+        }
 
-                    sqlite3_finalize(selectStmt);
+        for (const auto& encoding : benchmarkOptions.encodings) {
+            // Encode and decode alone, one reused buffer for the encoded form
+            std::string buffer;
+            size_t encodedBytes = 0;
+            double encodeTime = measureTime([&]() {
+                for (const auto& product : products) {
+                    encodeDocument(product, encoding, buffer);
+                    encodedBytes += buffer.size();
+                }
+            });
+            std::vector<std::string> encoded(products.size());
+            for (size_t i = 0; i < products.size(); i++) {
+                encodeDocument(products[i], encoding, encoded[i]);
+            }
+            size_t decoded = 0;
+            double decodeTime = measureTime([&]() {
+                for (const auto& document : encoded) {
+                    decoded += decodeDocument(document.data(), document.size(), encoding).size();
                 }
+            });
+            encoded.clear();
+
+            const std::string table = "products_encoded";
+            sqlite3_stmt* insert = nullptr;
+            sqlite3_stmt* query = nullptr;
+            if (!execSQL("DROP TABLE IF EXISTS " + table + ";") ||
+                !execSQL("CREATE TABLE " + table + " (id TEXT PRIMARY KEY, doc BLOB, category TEXT, price REAL);") ||
+                !execSQL("CREATE INDEX idx_" + table + "_price ON " + table + "(price);") ||
+                sqlite3_prepare_v2(db, ("INSERT INTO " + table + " VALUES (?, ?, ?, ?);").c_str(), -1, &insert, nullptr) != SQLITE_OK ||
+                sqlite3_prepare_v2(db, ("SELECT doc FROM " + table + " WHERE price > ? AND price < ?;").c_str(), -1, &query, nullptr) != SQLITE_OK) {
+                std::cerr << "Failed to prepare encoding table: " << sqlite3_errmsg(db) << std::endl;
+                sqlite3_finalize(insert);
+                return false;
             }
 
-            // Commit transaction
-            rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg);
-            if (rc != SQLITE_OK) {
-                std::cerr << "Failed to commit transaction: " << errMsg << std::endl;
-                sqlite3_free(errMsg);
+            // End to end: encode, bind and insert in one transaction, then price ranges decoded row by row
+            int inserted = 0;
+            double insertTime = measureTime([&]() {
+                execSQL("BEGIN TRANSACTION;");
+                for (int i = 0; i < NUM_DOCUMENTS; i++) {
+                    const json& product = products[i];
+                    std::string docId = makeDocId("prod", i);
+                    encodeDocument(product, encoding, buffer);
+                    sqlite3_reset(insert);
+                    sqlite3_bind_text(insert, 1, docId.c_str(), static_cast<int>(docId.size()), bindLifetime());
+                    if (encoding == "json") {
+                        sqlite3_bind_text(insert, 2, buffer.data(), static_cast<int>(buffer.size()), bindLifetime());
+                    } else {
+                        sqlite3_bind_blob(insert, 2, buffer.data(), static_cast<int>(buffer.size()), bindLifetime());
+                    }
+                    sqlite3_bind_text(insert, 3, product["category"].get_ref<const std::string&>().c_str(), -1, bindLifetime());
+                    sqlite3_bind_double(insert, 4, product["price"].get<double>());
+                    if (sqlite3_step(insert) == SQLITE_DONE) inserted++;
+                }
+                execSQL("COMMIT;");
+            });
+            size_t rows = 0;
+            uint64_t rowBytes = 0;
+            double queryTime = measureTime([&]() {
+                for (double low : lows) {
+                    sqlite3_reset(query);
+                    sqlite3_bind_double(query, 1, low);
+                    sqlite3_bind_double(query, 2, low + ENCODING_QUERY_WIDTH);
+                    while (sqlite3_step(query) == SQLITE_ROW) {
+                        const char* data = static_cast<const char*>(sqlite3_column_blob(query, 0));
+                        int bytes = sqlite3_column_bytes(query, 0);
+                        json doc = decodeDocument(data, bytes, encoding);
+                        rowBytes += bytes;
+                        rows++;
+                    }
+                }
+            });
+            sqlite3_finalize(insert);
+            sqlite3_finalize(query);
+            execSQL("DROP TABLE IF EXISTS " + table + ";");
+            if (inserted != NUM_DOCUMENTS || decoded == 0) {
+                std::cerr << "SQLite encoding " << encoding << ": inserted " << inserted << " of "
+                          << NUM_DOCUMENTS << " documents" << std::endl;
+                return false;
             }
-        });
 
-        results.updateOps = successCount;
+            recordPhaseResult("Encode " + encoding, encodeTime, NUM_DOCUMENTS, encodedBytes);
+            recordPhaseResult("Decode " + encoding, decodeTime, NUM_DOCUMENTS, encodedBytes);
+            recordPhaseResult("Encoded insert " + encoding, insertTime, NUM_DOCUMENTS, encodedBytes);
+            recordPhaseResult("Encoded query " + encoding, queryTime, NUM_QUERIES, rowBytes);
+            std::cout << "    " << testName << " encoding " << encoding << ": " << std::fixed << std::setprecision(1)
+                      << encodedBytes / double(NUM_DOCUMENTS) << " B/doc (" << encodedBytes * 100.0 / jsonBytes
+                      << "% of JSON), encode " << std::setprecision(2) << encodeTime * 1e6 / NUM_DOCUMENTS
+                      << " us/doc, decode " << decodeTime * 1e6 / NUM_DOCUMENTS << " us/doc, " << rows << " rows decoded by "
+                      << NUM_QUERIES << " queries" << std::endl;
+        }
         return true;
     }
 
-    bool runDeleteTest() override {
+    bool runNestedQueryTest() override {
         if (!db) return false;
 
-        int successCount = 0;
-        results.deleteTime = measureTime([&]() {
-            // Begin transaction for bulk delete
-            char* errMsg = nullptr;
-            int rc = sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
-            if (rc != SQLITE_OK) {
-                std::cerr << "Failed to begin transaction: " << errMsg << std::endl;
-                sqlite3_free(errMsg);
-                return;
+        for (const auto& field : NESTED_FIELDS) {
+            // Expression index over the JSON path; the query must repeat the same expression to use it
+            std::string expression = "json_extract(json_data, '$." + field.path + "')";
+            std::string indexName = "idx_products_json_" + field.path.substr(field.path.rfind('.') + 1);
+            bool indexed = false;
+            double indexTime = measureTime([&]() {
+                indexed = execSQL("CREATE INDEX " + indexName + " ON products(" + expression + ");");
+            });
+            if (indexed) {
+                recordPhaseResult("Index build " + field.path, indexTime, 1);
             }
 
-            for (int i = 0; i < NUM_DOCUMENTS / 4; i++) {
-                std::string docId = "prod" + std::to_string(i * 3);  // Delete every third document
+            const std::string select = "SELECT id, " + documentSQL() + " FROM products WHERE ";
+            recordPhaseResult("Eq " + field.path, timeQuery(select + expression + " = ?;", field.value));
+        }
 
-                std::string deleteSQL = "DELETE FROM products WHERE id = ?;";
-                sqlite3_stmt* deleteStmt;
-                rc = sqlite3_prepare_v2(db, deleteSQL.c_str(), -1, &deleteStmt, nullptr);
+        // Top-level indexed fields with comparable selectivity, for reference
+        const std::string select = "SELECT id, " + documentSQL() + " FROM products WHERE ";
+        recordPhaseResult("Eq category (top)", timeQuery(select + fieldSQL("category") + " = ?;", "Books"));
+        recordPhaseResult("Eq stock (top)", timeQuery(select + fieldSQL("stock") + " = ?;", "100"));
 
-                if (rc == SQLITE_OK) {
-                    sqlite3_bind_text(deleteStmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+        for (const auto& field : NESTED_FIELDS) {
+            execSQL("DROP INDEX IF EXISTS idx_products_json_" + field.path.substr(field.path.rfind('.') + 1) + ";");
+        }
+        return true;
+    }
 
-                    rc = sqlite3_step(deleteStmt);
-                    if (rc == SQLITE_DONE) {
-                        successCount++;
-                    }
+private:
+    sqlite3* db = nullptr;
+    sqlite3_stmt* insertStmt = nullptr;
 
-                    sqlite3_finalize(deleteStmt);
+    // Background checkpointer state for the passive/restart/truncate/idle strategies
+    std::thread checkpointThread;
+    std::atomic<bool> checkpointRunning{false};
+    std::atomic<int64_t> lastCommitMicros{0};
+    std::atomic<int> walPages{0};
+    std::mutex checkpointMutex;
+    LatencyStats checkpointLatency;
+    size_t checkpointBusy = 0;            // Checkpoints that could not finish for readers or a writer
+
+    static bool backgroundCheckpoint() {
+        const std::string& strategy = benchmarkOptions.sqliteCheckpoint;
+        return strategy != "default" && strategy.compare(0, 5, "auto-") != 0;
+    }
+
+    // Apply the per-connection options: the --cache-mb page cache size, --mmap and the --sqlite-checkpoint
+    // strategy, an autocheckpoint threshold or autocheckpoint off with commits reported to the
+    // background checkpointer. The checkpointer runs through every phase and its RESTART and
+    // TRUNCATE checkpoints hold the writer lock, so connections then wait on locks rather than
+    // failing with SQLITE_BUSY
+    void configureConnection(sqlite3* connection) {
+        if (benchmarkOptions.cacheMb > 0) {
+            // A negative cache_size is a budget in KiB rather than a page count
+            std::string pragma = "PRAGMA cache_size=-" + std::to_string(benchmarkOptions.cacheMb * 1024) + ";";
+            sqlite3_exec(connection, pragma.c_str(), nullptr, nullptr, nullptr);
+        }
+        if (benchmarkOptions.mmap) {
+            std::string pragma = "PRAGMA mmap_size=" + std::to_string(MMAP_SIZE_BYTES) + ";";
+            sqlite3_exec(connection, pragma.c_str(), nullptr, nullptr, nullptr);
+        }
+
+        const std::string& strategy = benchmarkOptions.sqliteCheckpoint;
+        if (strategy.compare(0, 5, "auto-") == 0) {
+            sqlite3_wal_autocheckpoint(connection, std::atoi(strategy.c_str() + 5));
+        } else if (backgroundCheckpoint()) {
+            // Installing a WAL hook replaces the autocheckpoint hook
+            sqlite3_wal_hook(connection, &SQLiteTest::recordCommit, this);
+            sqlite3_busy_timeout(connection, 5000);
+        }
+    }
+
+    static int recordCommit(void* self, sqlite3*, const char*, int pages) {
+        SQLiteTest* test = static_cast<SQLiteTest*>(self);
+        test->lastCommitMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        test->walPages = pages;
+        return SQLITE_OK;
+    }
+
+    void startCheckpointer() {
+        if (!backgroundCheckpoint()) return;
+        checkpointRunning = true;
+        checkpointThread = std::thread(&SQLiteTest::checkpointLoop, this);
+    }
+
+    void stopCheckpointer() {
+        if (!checkpointThread.joinable()) return;
+        checkpointRunning = false;
+        checkpointThread.join();
+    }
+
+    // Checkpoint from a dedicated connection on a timer, or whenever commits go quiet for "idle"
+    void checkpointLoop() {
+        sqlite3* connection;
+        if (sqlite3_open(DB_PATH_SQLITE.c_str(), &connection) != SQLITE_OK) {
+            std::cerr << "Checkpoint thread failed to open database" << std::endl;
+            sqlite3_close(connection);
+            return;
+        }
+        sqlite3_busy_timeout(connection, 100);
+        // A connection only checkpoints once it has seen the database in WAL mode
+        sqlite3_exec(connection, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+
+        const std::string& strategy = benchmarkOptions.sqliteCheckpoint;
+        bool idle = strategy == "idle";
+        int mode = strategy == "passive" ? SQLITE_CHECKPOINT_PASSIVE
+                 : strategy == "restart" ? SQLITE_CHECKPOINT_RESTART
+                 : SQLITE_CHECKPOINT_TRUNCATE;
+        while (checkpointRunning.load()) {
+            if (idle) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+                if (walPages.load() == 0 || now - lastCommitMicros.load() < CHECKPOINT_IDLE_MS * 1000) {
+                    continue;
                 }
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(CHECKPOINT_INTERVAL_MS));
             }
 
-            // Commit transaction
-            rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg);
-            if (rc != SQLITE_OK) {
-                std::cerr << "Failed to commit transaction: " << errMsg << std::endl;
-                sqlite3_free(errMsg);
+            int rc = SQLITE_OK;
+            double micros = measureLatency([&]() {
+                rc = sqlite3_wal_checkpoint_v2(connection, nullptr, mode, nullptr, nullptr);
+            });
+            if (rc == SQLITE_OK) {
+                walPages = 0;
             }
-        });
+            std::lock_guard<std::mutex> lock(checkpointMutex);
+            checkpointLatency.add(micros);
+            if (rc == SQLITE_BUSY) {
+                checkpointBusy++;
+            }
+        }
+        sqlite3_close(connection);
+    }
 
-        results.deleteOps = successCount;
+    // Run a statement that returns no rows, reporting any error
+    bool execSQL(const std::string& sql) {
+        return execSQL(db, sql);
+    }
+
+    // Remove a database file along with its -wal and -shm files
+    static void removeDatabaseFiles(const std::string& path) {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::remove((path + suffix).c_str());
+        }
+    }
+
+    static bool execSQL(sqlite3* connection, const std::string& sql) {
+        char* errMsg = nullptr;
+        int rc = sqlite3_exec(connection, sql.c_str(), nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "SQL error (" << sql << "): " << (errMsg ? errMsg : sqlite3_errmsg(connection)) << std::endl;
+            sqlite3_free(errMsg);
+            return false;
+        }
         return true;
     }
 
-    bool runParallelTest() override {
-        if (!db) return false;
+    // Step a (id, json_data, ...) query to completion, touching each document, and return the row count
+    static int stepRows(sqlite3_stmt* stmt) {
+        int count = 0;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            sqlite3_column_text(stmt, 1);
+            count++;
+        }
+        return count;
+    }
 
-        std::vector<std::thread> threads;
-        std::atomic<int> successCount(0);
-        std::mutex mtx;
+    // Latency of NESTED_REPEATS runs of a one-parameter (id, json_data) query
+    LatencyStats timeQuery(const std::string& sql, const std::string& parameter) {
+        LatencyStats latency;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare query (" << sql << "): " << sqlite3_errmsg(db) << std::endl;
+            return latency;
+        }
+        // Bind numbers as integers so they compare equal to INTEGER columns
+        bool numeric = !parameter.empty() && parameter.find_first_not_of("0123456789") == std::string::npos;
+        for (int r = 0; r < NESTED_REPEATS; r++) {
+            latency.add(measureLatency([&]() {
+                sqlite3_reset(stmt);
+                if (numeric) {
+                    sqlite3_bind_int(stmt, 1, std::atoi(parameter.c_str()));
+                } else {
+                    sqlite3_bind_text(stmt, 1, parameter.c_str(), -1, SQLITE_TRANSIENT);
+                }
+                stepRows(stmt);
+            }));
+        }
+        sqlite3_finalize(stmt);
+        return latency;
+    }
 
-        // Create a barrier to synchronize thread start
-        std::atomic<int> barrier(0);
+    // True when the schema stores hand-maintained copies of the indexed fields
+    static bool hasShadowColumns() {
+        return benchmarkOptions.sqliteSchema == "shadow" || benchmarkOptions.sqliteSchema == "without-rowid";
+    }
 
-        auto start = high_resolution_clock::now();
+    // Column or expression that reads field under the selected schema
+    static std::string fieldSQL(const std::string& field) {
+        const std::string& schema = benchmarkOptions.sqliteSchema;
+        if (schema == "expression" || schema == "jsonb") {
+            return "json_extract(json_data, '$." + field + "')";
+        }
+        return field;
+    }
 
-        // Each thread will need its own connection to the database
-        for (int t = 0; t < NUM_THREADS; t++) {
-            threads.emplace_back([&, t]() {
-                // Wait until all threads are ready
-                barrier.fetch_add(1);
-                while (barrier.load() < NUM_THREADS) {
-                    std::this_thread::yield();
-                }
+    // Expression that yields the document as JSON text
+    static std::string documentSQL() {
+        return benchmarkOptions.sqliteSchema == "jsonb" ? "json(json_data)" : "json_data";
+    }
 
-                // Open a new connection for this thread
-                sqlite3* threadDb;
-                int rc = sqlite3_open(DB_PATH_SQLITE.c_str(), &threadDb);
-                if (rc != SQLITE_OK) {
-                    std::cerr << "Thread " << t << " failed to open database: " << sqlite3_errmsg(threadDb) << std::endl;
-                    return;
-                }
+    // Placeholder that stores a bound JSON text parameter in the json_data column
+    static std::string documentParameterSQL() {
+        return benchmarkOptions.sqliteSchema == "jsonb" ? "jsonb(?)" : "?";
+    }
 
-                // Create prepared statement for inserts
-                sqlite3_stmt* threadInsertStmt;
-                const char* insertSQL =
-                    "INSERT INTO products (id, json_data, category, price, stock, rating, available) "
-                    "VALUES (?, ?, ?, ?, ?, ?, ?);";
-                rc = sqlite3_prepare_v2(threadDb, insertSQL, -1, &threadInsertStmt, nullptr);
+    static std::string createTableSQL(const std::string& table) {
+        const std::string& schema = benchmarkOptions.sqliteSchema;
+        if (schema == "generated") {
+            return "CREATE TABLE " + table + " ("
+                   "id TEXT PRIMARY KEY,"
+                   "json_data TEXT,"
+                   "category TEXT GENERATED ALWAYS AS (json_extract(json_data, '$.category')) VIRTUAL,"
+                   "price REAL GENERATED ALWAYS AS (json_extract(json_data, '$.price')) VIRTUAL,"
+                   "stock INTEGER GENERATED ALWAYS AS (json_extract(json_data, '$.stock')) VIRTUAL,"
+                   "rating REAL GENERATED ALWAYS AS (json_extract(json_data, '$.rating')) VIRTUAL,"
+                   "available INTEGER GENERATED ALWAYS AS (json_extract(json_data, '$.available')) VIRTUAL"
+                   ");";
+        }
+        if (schema == "expression") {
+            return "CREATE TABLE " + table + " (id TEXT PRIMARY KEY, json_data TEXT);";
+        }
+        if (schema == "jsonb") {
+            return "CREATE TABLE " + table + " (id TEXT PRIMARY KEY, json_data BLOB);";
+        }
+        return "CREATE TABLE " + table + " ("
+               "id TEXT PRIMARY KEY,"
+               "json_data TEXT,"
+               "category TEXT,"
+               "price REAL,"
+               "stock INTEGER,"
+               "rating REAL,"
+               "available INTEGER"
+               ")" + (schema == "without-rowid" ? " WITHOUT ROWID" : "") + ";";
+    }
 
-                if (rc != SQLITE_OK) {
-                    std::cerr << "Thread " << t << " failed to prepare insert statement: " << sqlite3_errmsg(threadDb) << std::endl;
-                    sqlite3_close(threadDb);
-                    return;
-                }
+    static std::string createIndexSQL(const std::string& table, const std::string& field) {
+        return "CREATE INDEX idx_" + table + "_" + field + " ON " + table + "(" + fieldSQL(field) + ");";
+    }
 
-                int threadSuccessCount = 0;
-                int docsPerThread = NUM_DOCUMENTS / NUM_THREADS;
-                int startIdx = t * docsPerThread;
-                int endIdx = startIdx + docsPerThread;
+    static std::string insertSQL(const std::string& table) {
+        if (hasShadowColumns()) {
+            return "INSERT INTO " + table + " (id, json_data, category, price, stock, rating, available) "
+                   "VALUES (?, ?, ?, ?, ?, ?, ?);";
+        }
+        return "INSERT INTO " + table + " (id, json_data) VALUES (?, " + documentParameterSQL() + ");";
+    }
 
-                // Begin transaction
-                char* errMsg = nullptr;
-                rc = sqlite3_exec(threadDb, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg);
-                if (rc != SQLITE_OK) {
-                    std::cerr << "Thread " << t << " failed to begin transaction: " << errMsg << std::endl;
-                    sqlite3_free(errMsg);
-                    sqlite3_finalize(threadInsertStmt);
-                    sqlite3_close(threadDb);
-                    return;
-                }
+    // Bind one product to a statement prepared from insertSQL()
+    // Under --sqlite-bind=static, docId, jsonStr and productData must outlive the step
+    static void bindProduct(sqlite3_stmt* stmt, const std::string& docId, const std::string& jsonStr, const json& productData) {
+        sqlite3_bind_text(stmt, 1, docId.c_str(), static_cast<int>(docId.size()), bindLifetime());
+        sqlite3_bind_text(stmt, 2, jsonStr.c_str(), static_cast<int>(jsonStr.size()), bindLifetime());
+        if (!hasShadowColumns()) return;
+
+        // Extract indexed fields from the JSON to maintain parity with AnuDB's indexing
+        sqlite3_bind_text(stmt, 3, productData["category"].get_ref<const std::string&>().c_str(), -1, bindLifetime());
+        sqlite3_bind_double(stmt, 4, productData["price"].get<double>());
+        sqlite3_bind_int(stmt, 5, productData["stock"].get<int>());
+        sqlite3_bind_double(stmt, 6, productData["rating"].get<double>());
+        sqlite3_bind_int(stmt, 7, productData["available"].get<bool>() ? 1 : 0);
+    }
 
-                // Each thread performs a mix of operations
-                for (int i = startIdx; i < endIdx; i++) {
-                    std::string docId = "parallel_prod" + std::to_string(i);
+    // bindProduct for a product built by buildFlatProduct, taking the shadow columns from its
+    // fields instead of looking them up in a json object
+    static void bindFlatProduct(sqlite3_stmt* stmt, const FlatProduct& flat) {
+        sqlite3_bind_text(stmt, 1, flat.docId.c_str(), static_cast<int>(flat.docId.size()), bindLifetime());
+        sqlite3_bind_text(stmt, 2, flat.json.c_str(), static_cast<int>(flat.json.size()), bindLifetime());
+        if (!hasShadowColumns()) return;
+
+        sqlite3_bind_text(stmt, 3, flat.category, -1, bindLifetime());
+        sqlite3_bind_double(stmt, 4, flat.price);
+        sqlite3_bind_int(stmt, 5, flat.stock);
+        sqlite3_bind_double(stmt, 6, flat.rating);
+        sqlite3_bind_int(stmt, 7, flat.stock > 0 ? 1 : 0);
+    }
 
-                    // Insert
-                    json productData = generateRandomProduct(i + 10000);  // Offset to avoid conflicts
-                    std::string jsonStr = productData.dump();
+    // UPDATE of one product's document, and its shadow columns where the schema has them
+    static std::string updateSQL(const std::string& table = "products") {
+        if (hasShadowColumns()) {
+            return "UPDATE " + table + " SET json_data = ?, price = ?, stock = ? WHERE id = ?;";
+        }
+        return "UPDATE " + table + " SET json_data = " + documentParameterSQL() + " WHERE id = ?;";
+    }
 
-                    sqlite3_reset(threadInsertStmt);
-                    sqlite3_bind_text(threadInsertStmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
-                    sqlite3_bind_text(threadInsertStmt, 2, jsonStr.c_str(), -1, SQLITE_TRANSIENT);
-                    // Also maintain indexed fields
-                    sqlite3_bind_text(threadInsertStmt, 3, productData["category"].get<std::string>().c_str(), -1, SQLITE_TRANSIENT);
-                    sqlite3_bind_double(threadInsertStmt, 4, productData["price"].get<double>());
-                    sqlite3_bind_int(threadInsertStmt, 5, productData["stock"].get<int>());
-                    sqlite3_bind_double(threadInsertStmt, 6, productData["rating"].get<double>());
-                    sqlite3_bind_int(threadInsertStmt, 7, productData["available"].get<bool>() ? 1 : 0);
+    // Reads over a table whose first deleted products are gone: point reads of the
+    // deleted ids, a price range query and a full scan, recorded with suffix
+    void timeTombstoneReads(const std::string& table, int deleted, const std::string& suffix) {
+        sqlite3_stmt* point;
+        sqlite3_stmt* range;
+        sqlite3_stmt* scan;
+        std::string pointSQL = "SELECT id, " + documentSQL() + " FROM " + table + " WHERE id = ?;";
+        std::string rangeSQL = "SELECT id, " + documentSQL() + " FROM " + table + " WHERE " + fieldSQL("price") +
+            " > 1000.0 AND " + fieldSQL("price") + " < 1100.0;";
+        std::string scanSQL = "SELECT id, " + documentSQL() + " FROM " + table + ";";
+        if (sqlite3_prepare_v2(db, pointSQL.c_str(), -1, &point, nullptr) != SQLITE_OK ||
+            sqlite3_prepare_v2(db, rangeSQL.c_str(), -1, &range, nullptr) != SQLITE_OK ||
+            sqlite3_prepare_v2(db, scanSQL.c_str(), -1, &scan, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare tombstone queries: " << sqlite3_errmsg(db) << std::endl;
+            return;
+        }
 
-                    rc = sqlite3_step(threadInsertStmt);
-                    if (rc == SQLITE_DONE) {
-                        threadSuccessCount++;
-                    }
+        LatencyStats missLatency;
+        for (int index : deletedProbeTargets(deleted)) {
+            std::string docId = makeDocId("prod", index);
+            missLatency.add(measureLatency([&]() {
+                sqlite3_reset(point);
+                sqlite3_bind_text(point, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+                stepRows(point);
+            }));
+        }
+        recordPhaseResult("Deleted reads" + suffix, missLatency);
+
+        LatencyStats rangeLatency;
+        LatencyStats scanLatency;
+        for (int r = 0; r < TOMBSTONE_REPEATS; r++) {
+            rangeLatency.add(measureLatency([&]() {
+                sqlite3_reset(range);
+                stepRows(range);
+            }));
+            scanLatency.add(measureLatency([&]() {
+                sqlite3_reset(scan);
+                stepRows(scan);
+            }));
+        }
+        recordPhaseResult("Range query" + suffix, rangeLatency);
+        recordPhaseResult("Scan" + suffix, scanLatency);
 
-                    // Query - using indexed fields when possible
-                    if (i % 5 == 0) {
-                        std::string category = productData["category"].get<std::string>();
-                        std::string querySQL = "SELECT id, json_data FROM products WHERE category = ?;";
-                        sqlite3_stmt* queryStmt;
-                        rc = sqlite3_prepare_v2(threadDb, querySQL.c_str(), -1, &queryStmt, nullptr);
+        sqlite3_finalize(point);
+        sqlite3_finalize(range);
+        sqlite3_finalize(scan);
+    }
 
-                        if (rc == SQLITE_OK) {
-                            sqlite3_bind_text(queryStmt, 1, category.c_str(), -1, SQLITE_TRANSIENT);
+    // In-place UPDATE for partial update operator op: ?1 is the operand, ?2 the id
+    static std::string partialUpdateSQL(const std::string& table, const std::string& op) {
+        // The jsonb_ variants keep a JSONB column in binary form
+        const std::string fn = benchmarkOptions.sqliteSchema == "jsonb" ? "jsonb_" : "json_";
+        std::string document;
+        std::string shadow;
+        if (op == "$set") {
+            document = fn + "set(json_data, '$.price', ?1)";
+            shadow = ", price = ?1";
+        } else if (op == "$inc") {
+            document = fn + "set(json_data, '$.stock', json_extract(json_data, '$.stock') + ?1)";
+            shadow = ", stock = stock + ?1";
+        } else if (op == "$push") {
+            document = fn + "insert(json_data, '$.tags[#]', ?1)";
+        } else {
+            document = fn + "patch(json_data, ?1)";
+            shadow = ", price = json_extract(?1, '$.price'), stock = json_extract(?1, '$.stock')";
+        }
+        return "UPDATE " + table + " SET json_data = " + document + (hasShadowColumns() ? shadow : "") + " WHERE id = ?2;";
+    }
 
-                            while (sqlite3_step(queryStmt) == SQLITE_ROW) {
-                                // Parse the returned JSON to simulate AnuDB behavior
-                                const char* jsonData = reinterpret_cast<const char*>(sqlite3_column_text(queryStmt, 1));
-                                json doc = json::parse(jsonData);
-                            }
+    // Bind the operand of partial update r to a statement prepared from partialUpdateSQL()
+    static void bindPartialUpdate(sqlite3_stmt* stmt, const std::string& op, int r) {
+        if (op == "$set") {
+            sqlite3_bind_double(stmt, 1, partialUpdatePrice(r));
+        } else if (op == "$inc") {
+            sqlite3_bind_int(stmt, 1, 1);
+        } else if (op == "$push") {
+            sqlite3_bind_text(stmt, 1, ("tag" + std::to_string(r)).c_str(), -1, SQLITE_TRANSIENT);
+        } else {
+            json patch = {{"price", partialUpdatePrice(r)}, {"stock", r % 500}};
+            sqlite3_bind_text(stmt, 1, patch.dump().c_str(), -1, SQLITE_TRANSIENT);
+        }
+    }
 
-                            sqlite3_finalize(queryStmt);
-                        }
-                    }
+    // Stored size of the listed products in table, read back outside any timed region
+    uint64_t documentBytes(const std::string& table, const std::vector<int>& indexes) {
+        uint64_t bytes = 0;
+        sqlite3_stmt* stmt;
+        std::string sql = "SELECT length(json_data) FROM " + table + " WHERE id = ?;";
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) return 0;
+        for (int index : indexes) {
+            std::string docId = makeDocId("prod", index);
+            sqlite3_reset(stmt);
+            sqlite3_bind_text(stmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                bytes += sqlite3_column_int64(stmt, 0);
+            }
+        }
+        sqlite3_finalize(stmt);
+        return bytes;
+    }
 
-                    // Update - now updating both JSON document and indexed fields
-                    if (i % 3 == 0) {
-                        double newPrice = productData["price"].get<double>() * 1.1;
-                        int newStock = i % 100;
-                        
-                        // First get the current JSON document
-                        std::string selectSQL = "SELECT json_data FROM products WHERE id = ?;";
-                        sqlite3_stmt* selectStmt;
-                        rc = sqlite3_prepare_v2(threadDb, selectSQL.c_str(), -1, &selectStmt, nullptr);
-                        
-                        if (rc == SQLITE_OK) {
-                            sqlite3_bind_text(selectStmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
-                            
-                            if (sqlite3_step(selectStmt) == SQLITE_ROW) {
-                                // Get and update the JSON document
-                                const char* jsonStr = reinterpret_cast<const char*>(sqlite3_column_text(selectStmt, 0));
-                                json docData = json::parse(jsonStr);
-                                
-                                // Modify the document
-                                docData["price"] = newPrice;
-                                docData["stock"] = newStock;
-                                docData["updated_at"] = getCurrentTimeString();
-                                
-                                // Update the document and indexed fields
-                                std::string updateSQL = 
-                                    "UPDATE products SET json_data = ?, price = ?, stock = ? WHERE id = ?;";
-                                sqlite3_stmt* updateStmt;
-                                rc = sqlite3_prepare_v2(threadDb, updateSQL.c_str(), -1, &updateStmt, nullptr);
-                                
-                                if (rc == SQLITE_OK) {
-                                    std::string updatedJsonStr = docData.dump();
-                                    
-                                    sqlite3_bind_text(updateStmt, 1, updatedJsonStr.c_str(), -1, SQLITE_TRANSIENT);
-                                    sqlite3_bind_double(updateStmt, 2, newPrice);
-                                    sqlite3_bind_int(updateStmt, 3, newStock);
-                                    sqlite3_bind_text(updateStmt, 4, docId.c_str(), -1, SQLITE_TRANSIENT);
-                                    
-                                    sqlite3_step(updateStmt);
-                                    sqlite3_finalize(updateStmt);
-                                }
-                            }
-                            
-                            sqlite3_finalize(selectStmt);
-                        }
-                    }
+    // Bind a statement prepared from updateSQL()
+    static void bindUpdate(sqlite3_stmt* stmt, const std::string& jsonStr, double price, int stock, const std::string& docId) {
+        sqlite3_bind_text(stmt, 1, jsonStr.c_str(), static_cast<int>(jsonStr.size()), bindLifetime());
+        if (hasShadowColumns()) {
+            sqlite3_bind_double(stmt, 2, price);
+            sqlite3_bind_int(stmt, 3, stock);
+            sqlite3_bind_text(stmt, 4, docId.c_str(), static_cast<int>(docId.size()), bindLifetime());
+        } else {
+            sqlite3_bind_text(stmt, 2, docId.c_str(), static_cast<int>(docId.size()), bindLifetime());
+        }
+    }
 
-                    // Delete
-                    if (i % 7 == 0) {
-                        std::string deleteSQL = "DELETE FROM products WHERE id = ?;";
-                        sqlite3_stmt* deleteStmt;
-                        rc = sqlite3_prepare_v2(threadDb, deleteSQL.c_str(), -1, &deleteStmt, nullptr);
+    // SQLITE_STATIC under --sqlite-bind=static, where the bound buffer must stay valid until the
+    // statement is stepped, SQLITE_TRANSIENT (SQLite takes its own copy) otherwise
+    static sqlite3_destructor_type bindLifetime() {
+        return benchmarkOptions.sqliteBind == "static" ? SQLITE_STATIC : SQLITE_TRANSIENT;
+    }
 
-                        if (rc == SQLITE_OK) {
-                            sqlite3_bind_text(deleteStmt, 1, docId.c_str(), -1, SQLITE_TRANSIENT);
+    // Stream buffer appending to a std::string, whose capacity survives clear()
+    class StringSink : public std::streambuf {
+    public:
+        explicit StringSink(std::string& target) : target(target) {}
 
-                            sqlite3_step(deleteStmt);
-                            sqlite3_finalize(deleteStmt);
-                        }
-                    }
-                }
+    protected:
+        int_type overflow(int_type ch) override {
+            if (ch != traits_type::eof()) target += static_cast<char>(ch);
+            return ch;
+        }
+        std::streamsize xsputn(const char* data, std::streamsize count) override {
+            target.append(data, static_cast<size_t>(count));
+            return count;
+        }
+
+    private:
+        std::string& target;
+    };
+
+    // product serialized as by dump(). Under --sqlite-bind=static it is written into this
+    // thread's reused buffer, which stops allocating once grown; either way the result is
+    // valid until the thread's next call
+    static const std::string& serializeDocument(const json& product) {
+        static thread_local std::string buffer;
+        if (benchmarkOptions.sqliteBind != "static") {
+            buffer = product.dump();
+            return buffer;
+        }
+        static thread_local StringSink sink(buffer);
+        static thread_local std::ostream out(&sink);
+        buffer.clear();
+        out << product;
+        return buffer;
+    }
+
+    // product in encoding, one of DOCUMENT_ENCODINGS, written into out; out keeps its capacity
+    static void encodeDocument(const json& product, const std::string& encoding, std::string& out) {
+        out.clear();
+        if (encoding == "cbor") {
+            json::to_cbor(product, out);
+        } else if (encoding == "msgpack") {
+            json::to_msgpack(product, out);
+        } else if (encoding == "bson") {
+            json::to_bson(product, out);
+        } else if (encoding == "ubjson") {
+            json::to_ubjson(product, out);
+        } else {
+            StringSink sink(out);
+            std::ostream stream(&sink);
+            stream << product;
+        }
+    }
+
+    // Document of bytes bytes at data in encoding, as written by encodeDocument
+    static json decodeDocument(const char* data, size_t bytes, const std::string& encoding) {
+        if (encoding == "cbor") return json::from_cbor(data, data + bytes);
+        if (encoding == "msgpack") return json::from_msgpack(data, data + bytes);
+        if (encoding == "bson") return json::from_bson(data, data + bytes);
+        if (encoding == "ubjson") return json::from_ubjson(data, data + bytes);
+        return json::parse(data, data + bytes);
+    }
+
+    // Document text in column col of the current row. sqlite3_column_text may copy the value
+    // to NUL-terminate it; under --sqlite-bind=static sqlite3_column_blob returns it in place,
+    // with sqlite3_column_bytes as its length
+    static const char* documentColumn(sqlite3_stmt* stmt, int col) {
+        if (benchmarkOptions.sqliteBind == "static") {
+            return static_cast<const char*>(sqlite3_column_blob(stmt, col));
+        }
+        return reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+    }
 
-                // Commit transaction
-                rc = sqlite3_exec(threadDb, "COMMIT;", nullptr, nullptr, &errMsg);
-                if (rc != SQLITE_OK) {
-                    std::cerr << "Thread " << t << " failed to commit transaction: " << errMsg << std::endl;
-                    sqlite3_free(errMsg);
-                }
+    // Document in column col of the current row, parsed straight from SQLite's buffer
+    static json parseDocumentColumn(sqlite3_stmt* stmt, int col) {
+        if (benchmarkOptions.sqliteBind == "static") {
+            const char* data = documentColumn(stmt, col);
+            return json::parse(data, data + sqlite3_column_bytes(stmt, col));
+        }
+        return json::parse(reinterpret_cast<const char*>(sqlite3_column_text(stmt, col)));
+    }
 
-                // Clean up
-                sqlite3_finalize(threadInsertStmt);
-                sqlite3_close(threadDb);
+    // Insert products prod0..prod<count-1> into table in one transaction and return how many succeeded
+    int insertProducts(const std::string& table, int count) {
+        return insertProducts(db, table, count);
+    }
 
-                successCount.fetch_add(threadSuccessCount);
-            });
+    int insertProducts(sqlite3* connection, const std::string& table, int count) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(connection, insertSQL(table).c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare insert statement: " << sqlite3_errmsg(connection) << std::endl;
+            return 0;
         }
 
-        // Join all threads
-        for (auto& thread : threads) {
-            thread.join();
+        int successCount = 0;
+        execSQL(connection, "BEGIN TRANSACTION;");
+        for (int i = 0; i < count; i++) {
+            json productData = generateRandomProduct(i);
+            std::string docId = makeDocId("prod", i);
+            std::string jsonStr = productData.dump();
+
+            sqlite3_reset(stmt);
+            bindProduct(stmt, docId, jsonStr, productData);
+
+            if (sqlite3_step(stmt) == SQLITE_DONE) {
+                successCount++;
+            }
         }
+        execSQL(connection, "COMMIT;");
 
-        auto end = high_resolution_clock::now();
-        results.parallelTime = duration_cast<milliseconds>(end - start).count() / 1000.0;
-        results.parallelOps = successCount.load();
+        sqlite3_finalize(stmt);
+        return successCount;
+    }
+};
 
-        return true;
+// Run one phase of test, recording the page faults it caused and the RSS after it
+template <typename Phase>
+bool runTracked(BenchmarkTest& test, const std::string& phase, Phase run) {
+    struct rusage before;
+    struct rusage after;
+    ProcessIo ioBefore;
+    HeapPeakSampler heapPeak;
+    if (benchmarkOptions.allocStats) {
+        heapPeak.start();
+    }
+    AllocTotals allocBefore = allocTotals();
+    size_t firstResult = test.phaseResults.size();
+    if (benchmarkOptions.ioStats) {
+        // Drop I/O counted since the last phase, setup included
+        takeIoStats();
+        ioBefore = currentProcessIo();
+    }
+    getrusage(RUSAGE_SELF, &before);
+    bool ok = run();
+    getrusage(RUSAGE_SELF, &after);
+    BenchmarkTest::ResourceSample sample = {phase, after.ru_minflt - before.ru_minflt,
+                                            after.ru_majflt - before.ru_majflt, currentRssBytes()};
+    test.resourceUsage.push_back(sample);
+
+    if (benchmarkOptions.ioStats) {
+        ProcessIo ioAfter = currentProcessIo();
+        BenchmarkTest::IoSample io;
+        io.phase = phase;
+        io.files = takeIoStats();
+        io.process.readCalls = ioAfter.readCalls - ioBefore.readCalls;
+        io.process.readBytes = ioAfter.readBytes - ioBefore.readBytes;
+        io.process.writeCalls = ioAfter.writeCalls - ioBefore.writeCalls;
+        io.process.writeBytes = ioAfter.writeBytes - ioBefore.writeBytes;
+        test.ioUsage.push_back(io);
     }
 
-private:
-    sqlite3* db = nullptr;
-    sqlite3_stmt* insertStmt = nullptr;
-};
+    if (benchmarkOptions.allocStats) {
+        AllocTotals allocAfter = allocTotals();
+        BenchmarkTest::AllocSample alloc;
+        alloc.phase = phase;
+        alloc.operations = test.phaseOperations(phase, firstResult);
+        for (int engine = 0; engine < 2; engine++) {
+            alloc.totals.allocations[engine] = allocAfter.allocations[engine] - allocBefore.allocations[engine];
+            alloc.totals.bytes[engine] = allocAfter.bytes[engine] - allocBefore.bytes[engine];
+        }
+        alloc.peakHeapBytes = std::max<int64_t>(0, heapPeak.stop());
+        test.allocUsage.push_back(alloc);
+    }
+    return ok;
+}
 
 // Function to run all tests and print results
-void runBenchmarks() {
+void runBenchmarks(const std::string& configLabel, bool appendReport) {
     std::vector<std::unique_ptr<BenchmarkTest>> tests;
     tests.push_back(std::make_unique<AnuDBTest>());
     tests.push_back(std::make_unique<SQLiteTest>());
@@ -935,11 +5426,42 @@ void runBenchmarks() {
     std::cout << "- Documents: " << NUM_DOCUMENTS << std::endl;
     std::cout << "- Queries: " << NUM_QUERIES << std::endl;
     std::cout << "- Parallel Threads: " << NUM_THREADS << std::endl;
+    std::cout << "- Key Format: " << benchmarkOptions.keyFormat << std::endl;
+    std::cout << "- Document Size: " << benchmarkOptions.docSize << std::endl;
+    std::cout << "- SQLite Schema: " << benchmarkOptions.sqliteSchema << std::endl;
+    std::cout << "- SQLite Checkpoint: " << benchmarkOptions.sqliteCheckpoint << std::endl;
+    std::cout << "- SQLite Bind: " << benchmarkOptions.sqliteBind << std::endl;
+    std::cout << "- Cache Budget: " << (benchmarkOptions.cacheMb > 0 ? std::to_string(benchmarkOptions.cacheMb) + " MB" : "engine defaults") << std::endl;
+    std::cout << "- Memory-Mapped Reads: " << (benchmarkOptions.mmap ? "on" : "off") << std::endl;
+    std::cout << "- I/O Accounting: " << (benchmarkOptions.ioStats ? "on" : "off") << std::endl;
+    std::cout << "- Storage Profile: " << STORAGE_PROFILES[benchmarkOptions.storageProfile].name << std::endl;
+    std::cout << "- Allocation Counting: " << (benchmarkOptions.allocStats ? "on" : "off") << std::endl;
+    std::cout << "- CPU Cores: " << allowedCpus().size() << (benchmarkOptions.pinThreads ? ", parallel workers pinned" : "") << std::endl;
+    if (benchmarkOptions.addressSpaceMb > 0) {
+        std::cout << "- Address Space Limit: " << benchmarkOptions.addressSpaceMb << " MB" << std::endl;
+    }
+    if (!configLabel.empty()) {
+        std::cout << "- Sweep Config: " << configLabel << std::endl;
+    }
+    if (!benchmarkOptions.phases.empty()) {
+        std::cout << "- Extra Phases:";
+        for (const auto& phase : benchmarkOptions.phases) {
+            std::cout << " " << phase;
+        }
+        std::cout << std::endl;
+    }
+    if (benchmarkOptions.runPhase("index")) {
+        std::cout << "- Index Build Documents: " << benchmarkOptions.indexBuildDocuments << std::endl;
+    }
     std::cout << std::endl;
 
     for (auto& test : tests) {
         std::cout << "Running " << test->getName() << " tests..." << std::endl;
 
+        // The engines share the process, so memory is measured from what the previous one left
+        uint64_t rssBefore = currentRssBytes();
+        bool peakReset = resetPeakRss();
+
         // Setup test
         if (!test->setup()) {
             std::cerr << "Failed to set up " << test->getName() << " test." << std::endl;
@@ -948,32 +5470,158 @@ void runBenchmarks() {
 
         // Run insert test
         std::cout << "  Running insert test..." << std::endl;
-        if (!test->runInsertTest()) {
+        if (!runTracked(*test, "Insert", [&]() { return test->runInsertTest(); })) {
             std::cerr << "Failed to run insert test for " << test->getName() << std::endl;
         }
 
         // Run query test
         std::cout << "  Running query test..." << std::endl;
-        if (!test->runQueryTest()) {
+        if (!runTracked(*test, "Query", [&]() { return test->runQueryTest(); })) {
             std::cerr << "Failed to run query test for " << test->getName() << std::endl;
         }
 
         // Run update test
         std::cout << "  Running update test..." << std::endl;
-        if (!test->runUpdateTest()) {
+        if (!runTracked(*test, "Update", [&]() { return test->runUpdateTest(); })) {
             std::cerr << "Failed to run update test for " << test->getName() << std::endl;
         }
         // Run delete test
         std::cout << "  Running delete test..." << std::endl;
-        if (!test->runDeleteTest()) {
+        if (!runTracked(*test, "Delete", [&]() { return test->runDeleteTest(); })) {
             std::cerr << "Failed to run delete test for " << test->getName() << std::endl;
         }
         // Run parallel test
         std::cout << "  Running parallel operations test..." << std::endl;
-        if (!test->runParallelTest()) {
+        if (!runTracked(*test, "Parallel", [&]() { return test->runParallelTest(); })) {
             std::cerr << "Failed to run parallel test for " << test->getName() << std::endl;
         }
 
+        // Run index cost test
+        if (benchmarkOptions.runPhase("index")) {
+            std::cout << "  Running index test..." << std::endl;
+            if (!runTracked(*test, "index", [&]() { return test->runIndexTest(); })) {
+                std::cerr << "Failed to run index test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run top-K and pagination test
+        if (benchmarkOptions.runPhase("topk")) {
+            std::cout << "  Running top-K and pagination test..." << std::endl;
+            if (!runTracked(*test, "topk", [&]() { return test->runTopKTest(); })) {
+                std::cerr << "Failed to run top-K test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run grouped aggregation test
+        if (benchmarkOptions.runPhase("aggregate")) {
+            std::cout << "  Running aggregation test..." << std::endl;
+            if (!runTracked(*test, "aggregate", [&]() { return test->runAggregationTest(); })) {
+                std::cerr << "Failed to run aggregation test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run full scan, export and import test
+        if (benchmarkOptions.runPhase("scan")) {
+            std::cout << "  Running scan, export and import test..." << std::endl;
+            if (!runTracked(*test, "scan", [&]() { return test->runScanTest(); })) {
+                std::cerr << "Failed to run scan test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run nested and sparse field query test
+        if (benchmarkOptions.runPhase("nested")) {
+            std::cout << "  Running nested field query test..." << std::endl;
+            if (!runTracked(*test, "nested", [&]() { return test->runNestedQueryTest(); })) {
+                std::cerr << "Failed to run nested query test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run partial update test
+        if (benchmarkOptions.runPhase("partial")) {
+            std::cout << "  Running partial update test..." << std::endl;
+            if (!runTracked(*test, "partial", [&]() { return test->runPartialUpdateTest(); })) {
+                std::cerr << "Failed to run partial update test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run delete-heavy tombstone test
+        if (benchmarkOptions.runPhase("tombstone")) {
+            std::cout << "  Running delete-heavy tombstone test..." << std::endl;
+            if (!runTracked(*test, "tombstone", [&]() { return test->runTombstoneTest(); })) {
+                std::cerr << "Failed to run tombstone test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run time-series test
+        if (benchmarkOptions.runPhase("timeseries")) {
+            std::cout << "  Running time-series test..." << std::endl;
+            if (!runTracked(*test, "timeseries", [&]() { return test->runTimeSeriesTest(); })) {
+                std::cerr << "Failed to run time-series test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run soak test
+        if (benchmarkOptions.runPhase("soak")) {
+            std::cout << "  Running soak test for " << benchmarkOptions.soakDuration << " s..." << std::endl;
+            if (!runTracked(*test, "soak", [&]() { return test->runSoakTest(); })) {
+                std::cerr << "Failed to run soak test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run read-while-write interference test
+        if (benchmarkOptions.runPhase("interference")) {
+            std::cout << "  Running read-while-write interference test..." << std::endl;
+            if (!runTracked(*test, "interference", [&]() { return test->runInterferenceTest(); })) {
+                std::cerr << "Failed to run interference test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run WAL checkpoint test
+        if (benchmarkOptions.runPhase("checkpoint")) {
+            std::cout << "  Running WAL checkpoint test..." << std::endl;
+            if (!runTracked(*test, "checkpoint", [&]() { return test->runCheckpointTest(); })) {
+                std::cerr << "Failed to run checkpoint test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run cold start test
+        if (benchmarkOptions.runPhase("coldstart")) {
+            std::cout << "  Running cold start test..." << std::endl;
+            if (!runTracked(*test, "coldstart", [&]() { return test->runColdStartTest(); })) {
+                std::cerr << "Failed to run cold start test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run crash recovery test
+        if (benchmarkOptions.runPhase("crash")) {
+            std::cout << "  Running crash recovery test..." << std::endl;
+            if (!runTracked(*test, "crash", [&]() { return test->runCrashTest(); })) {
+                std::cerr << "Failed to run crash recovery test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run document builder test
+        if (benchmarkOptions.runPhase("builder")) {
+            std::cout << "  Running document builder test..." << std::endl;
+            if (!runTracked(*test, "builder", [&]() { return test->runBuilderTest(); })) {
+                std::cerr << "Failed to run document builder test for " << test->getName() << std::endl;
+            }
+        }
+
+        // Run document encoding test
+        if (benchmarkOptions.runPhase("encoding")) {
+            std::cout << "  Running document encoding test..." << std::endl;
+            if (!runTracked(*test, "encoding", [&]() { return test->runEncodingTest(); })) {
+                std::cerr << "Failed to run document encoding test for " << test->getName() << std::endl;
+            }
+        }
+
+        test->results.footprintBytes = test->footprintBytes();
+        uint64_t rssAfter = currentRssBytes();
+        test->results.rssBytes = rssAfter > rssBefore ? rssAfter - rssBefore : 0;
+        uint64_t peak = peakReset ? std::max(peakRssBytes(), rssAfter) : 0;
+        test->results.peakRssBytes = peak > rssBefore ? peak - rssBefore : 0;
+
         // Cleanup test
         if (!test->cleanup()) {
             std::cerr << "Failed to clean up " << test->getName() << " test." << std::endl;
@@ -986,12 +5634,22 @@ void runBenchmarks() {
     // Print results table
     std::cout << "\n===== Benchmark Results =====" << std::endl;
 
+    // Throughput column, "-" when the phase does not measure bytes
+    auto printMBPerSec = [](uint64_t bytes, double time) {
+        if (bytes > 0 && time > 0) {
+            std::cout << std::setw(15) << std::fixed << std::setprecision(2) << bytes / (1024.0 * 1024.0) / time;
+        } else {
+            std::cout << std::setw(15) << "-";
+        }
+    };
+
     // Header
     std::cout << std::left << std::setw(20) << "Operation";
     for (const auto& test : tests) {
         std::cout << std::setw(15) << test->getName() + " Time(s)";
         std::cout << std::setw(15) << test->getName() + " Ops";
         std::cout << std::setw(15) << test->getName() + " Ops/s";
+        std::cout << std::setw(15) << test->getName() + " MB/s";
     }
     std::cout << std::endl;
 
@@ -1003,6 +5661,7 @@ void runBenchmarks() {
         std::cout << std::setw(15) << results.insertOps;
         double opsPerSec = results.insertTime > 0 ? results.insertOps / results.insertTime : 0;
         std::cout << std::setw(15) << std::fixed << std::setprecision(1) << opsPerSec;
+        printMBPerSec(results.insertBytes, results.insertTime);
     }
     std::cout << std::endl;
 
@@ -1014,6 +5673,7 @@ void runBenchmarks() {
         std::cout << std::setw(15) << results.queryOps;
         double opsPerSec = results.queryTime > 0 ? results.queryOps / results.queryTime : 0;
         std::cout << std::setw(15) << std::fixed << std::setprecision(1) << opsPerSec;
+        printMBPerSec(results.queryBytes, results.queryTime);
     }
     std::cout << std::endl;
 
@@ -1025,6 +5685,7 @@ void runBenchmarks() {
         std::cout << std::setw(15) << results.updateOps;
         double opsPerSec = results.updateTime > 0 ? results.updateOps / results.updateTime : 0;
         std::cout << std::setw(15) << std::fixed << std::setprecision(1) << opsPerSec;
+        printMBPerSec(results.updateBytes, results.updateTime);
     }
     std::cout << std::endl;
 
@@ -1036,6 +5697,7 @@ void runBenchmarks() {
         std::cout << std::setw(15) << results.deleteOps;
         double opsPerSec = results.deleteTime > 0 ? results.deleteOps / results.deleteTime : 0;
         std::cout << std::setw(15) << std::fixed << std::setprecision(1) << opsPerSec;
+        printMBPerSec(0, results.deleteTime);
     }
     std::cout << std::endl;
 
@@ -1047,6 +5709,33 @@ void runBenchmarks() {
         std::cout << std::setw(15) << results.parallelOps;
         double opsPerSec = results.parallelTime > 0 ? results.parallelOps / results.parallelTime : 0;
         std::cout << std::setw(15) << std::fixed << std::setprecision(1) << opsPerSec;
+        printMBPerSec(results.parallelBytes, results.parallelTime);
+    }
+    std::cout << std::endl;
+
+    // On-disk size after all phases
+    std::cout << std::left << std::setw(20) << "Footprint(MB)";
+    for (const auto& test : tests) {
+        std::cout << std::setw(60) << std::fixed << std::setprecision(2)
+                  << test->results.footprintBytes / (1024.0 * 1024.0);
+    }
+    std::cout << std::endl;
+
+    // Process RSS each engine added, with it still open, and at its peak
+    std::cout << std::left << std::setw(20) << "RSS growth(MB)";
+    for (const auto& test : tests) {
+        std::cout << std::setw(60) << std::fixed << std::setprecision(2)
+                  << test->results.rssBytes / (1024.0 * 1024.0);
+    }
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(20) << "Peak RSS growth(MB)";
+    for (const auto& test : tests) {
+        if (test->results.peakRssBytes > 0) {
+            std::cout << std::setw(60) << std::fixed << std::setprecision(2)
+                      << test->results.peakRssBytes / (1024.0 * 1024.0);
+        } else {
+            std::cout << std::setw(60) << "-";
+        }
     }
     std::cout << std::endl;
 
@@ -1054,6 +5743,11 @@ void runBenchmarks() {
     if (tests.size() >= 2) {
         std::cout << "\n===== Performance Comparison =====" << std::endl;
         std::cout << "Ratio of AnuDB to SQLite3 (higher means AnuDB is faster)" << std::endl;
+        if (benchmarkOptions.storageProfile != 0) {
+            // Only SQLite's VFS can be slowed down, so the two engines did not see the same device
+            std::cout << "SQLite emulated (" << STORAGE_PROFILES[benchmarkOptions.storageProfile].name
+                      << " storage profile), AnuDB native: not a like-for-like comparison" << std::endl;
+        }
 
         const auto& anudbResults = tests[0]->results;
         const auto& sqliteResults = tests[1]->results;
@@ -1097,11 +5791,142 @@ void runBenchmarks() {
                   << std::setw(15) << std::fixed << std::setprecision(2) << parallelOpsRatio << std::endl;
     }
 
+    // Page faults caused by each phase and the RSS after it
+    std::cout << "\n===== Resource Usage =====" << std::endl;
+    std::cout << std::left << std::setw(20) << "Phase";
+    for (const auto& test : tests) {
+        std::cout << std::setw(20) << test->getName() + " MinFlt";
+        std::cout << std::setw(20) << test->getName() + " MajFlt";
+        std::cout << std::setw(20) << test->getName() + " RSS(MB)";
+    }
+    std::cout << std::endl;
+    for (size_t i = 0; i < tests.front()->resourceUsage.size(); i++) {
+        std::cout << std::left << std::setw(20) << tests.front()->resourceUsage[i].phase;
+        for (const auto& test : tests) {
+            if (i >= test->resourceUsage.size()) {
+                std::cout << std::setw(20) << "-" << std::setw(20) << "-" << std::setw(20) << "-";
+                continue;
+            }
+            const auto& sample = test->resourceUsage[i];
+            std::cout << std::setw(20) << sample.minorFaults << std::setw(20) << sample.majorFaults
+                      << std::setw(20) << std::fixed << std::setprecision(2) << sample.rssBytes / (1024.0 * 1024.0);
+        }
+        std::cout << std::endl;
+    }
+
+    if (benchmarkOptions.ioStats) {
+        // One row per phase and file type the VFS saw, plus the process-wide syscall totals,
+        // which are all there is for AnuDB: it builds its RocksDB Env internally
+        std::cout << "\n===== I/O Accounting =====" << std::endl;
+        auto latency = [](const LatencyHistogram& histogram) {
+            if (histogram.count() == 0) return std::string("-");
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(3) << histogram.percentileMs(50) << "/" << histogram.percentileMs(99);
+            return out.str();
+        };
+        for (const auto& test : tests) {
+            std::cout << test->getName() << " (P50/P99 in ms)" << std::endl;
+            std::cout << std::left << std::setw(20) << "Phase" << std::setw(10) << "File" << std::setw(12) << "Reads"
+                      << std::setw(12) << "Read(MB)" << std::setw(16) << "Read P50/P99" << std::setw(12) << "Writes"
+                      << std::setw(12) << "Write(MB)" << std::setw(16) << "Write P50/P99" << std::setw(10) << "Syncs"
+                      << "Sync P50/P99" << std::endl;
+            for (const auto& sample : test->ioUsage) {
+                for (int type = 0; type < IO_FILE_TYPES; type++) {
+                    const IoTypeStats& stats = sample.files[type];
+                    if (stats.reads + stats.writes + stats.syncs == 0) continue;
+                    std::cout << std::setw(20) << sample.phase << std::setw(10) << IO_FILE_TYPE_NAMES[type]
+                              << std::setw(12) << stats.reads << std::setw(12) << std::fixed << std::setprecision(2)
+                              << stats.readBytes / (1024.0 * 1024.0) << std::setw(16) << latency(stats.readLatency)
+                              << std::setw(12) << stats.writes << std::setw(12) << std::setprecision(2)
+                              << stats.writeBytes / (1024.0 * 1024.0) << std::setw(16) << latency(stats.writeLatency)
+                              << std::setw(10) << stats.syncs << latency(stats.syncLatency) << std::endl;
+                }
+                const ProcessIo& process = sample.process;
+                std::cout << std::setw(20) << sample.phase << std::setw(10) << "process" << std::setw(12) << process.readCalls
+                          << std::setw(12) << std::fixed << std::setprecision(2) << process.readBytes / (1024.0 * 1024.0)
+                          << std::setw(16) << "-" << std::setw(12) << process.writeCalls << std::setw(12)
+                          << process.writeBytes / (1024.0 * 1024.0) << std::setw(16) << "-" << std::setw(10) << "-"
+                          << "-" << std::endl;
+            }
+        }
+    }
+
+    if (benchmarkOptions.allocStats) {
+        std::cout << "\n===== Allocations =====" << std::endl;
+        for (const auto& test : tests) {
+            std::cout << test->getName() << std::endl;
+            std::cout << std::left << std::setw(20) << "Phase" << std::setw(10) << "Ops" << std::setw(18) << "Harness Alloc/op"
+                      << std::setw(18) << "Harness B/op" << std::setw(18) << "Engine Alloc/op" << std::setw(18) << "Engine B/op"
+                      << "Peak Heap(MB)" << std::endl;
+            for (const auto& sample : test->allocUsage) {
+                double ops = static_cast<double>(std::max<size_t>(1, sample.operations));
+                std::cout << std::setw(20) << sample.phase << std::setw(10) << sample.operations << std::fixed << std::setprecision(1)
+                          << std::setw(18) << sample.totals.allocations[0] / ops << std::setw(18) << sample.totals.bytes[0] / ops
+                          << std::setw(18) << sample.totals.allocations[1] / ops << std::setw(18) << sample.totals.bytes[1] / ops
+                          << std::setprecision(2) << sample.peakHeapBytes / (1024.0 * 1024.0) << std::endl;
+            }
+        }
+    }
+
+    // Extra phase results, one row per operation in the order first reported
+    std::vector<std::string> phaseOperations;
+    for (const auto& test : tests) {
+        for (const auto& result : test->phaseResults) {
+            if (std::find(phaseOperations.begin(), phaseOperations.end(), result.operation) == phaseOperations.end()) {
+                phaseOperations.push_back(result.operation);
+            }
+        }
+    }
+
+    if (!phaseOperations.empty()) {
+        std::cout << "\n===== Extra Phase Results =====" << std::endl;
+
+        std::cout << std::left << std::setw(28) << "Operation";
+        for (const auto& test : tests) {
+            std::cout << std::setw(15) << test->getName() + " Time(s)";
+            std::cout << std::setw(15) << test->getName() + " Ops";
+            std::cout << std::setw(15) << test->getName() + " Ops/s";
+            std::cout << std::setw(15) << test->getName() + " P50(ms)";
+            std::cout << std::setw(15) << test->getName() + " P99(ms)";
+            std::cout << std::setw(15) << test->getName() + " MB/s";
+        }
+        std::cout << std::endl;
+
+        for (const auto& operation : phaseOperations) {
+            std::cout << std::left << std::setw(28) << operation;
+            for (const auto& test : tests) {
+                auto it = std::find_if(test->phaseResults.begin(), test->phaseResults.end(),
+                    [&](const BenchmarkTest::PhaseResult& result) { return result.operation == operation; });
+                if (it == test->phaseResults.end()) {
+                    for (int column = 0; column < 6; column++) {
+                        std::cout << std::setw(15) << "-";
+                    }
+                    continue;
+                }
+                std::cout << std::setw(15) << std::fixed << std::setprecision(3) << it->time;
+                std::cout << std::setw(15) << it->ops;
+                double opsPerSec = it->time > 0 ? it->ops / it->time : 0;
+                std::cout << std::setw(15) << std::fixed << std::setprecision(1) << opsPerSec;
+                // Same column order as the CSV: latency percentiles, then throughput
+                if (it->hasLatency) {
+                    std::cout << std::setw(15) << std::fixed << std::setprecision(3) << it->p50Ms;
+                    std::cout << std::setw(15) << std::fixed << std::setprecision(3) << it->p99Ms;
+                } else {
+                    std::cout << std::setw(15) << "-" << std::setw(15) << "-";
+                }
+                printMBPerSec(it->bytes, it->time);
+            }
+            std::cout << std::endl;
+        }
+    }
+
     // Generate benchmark report for visualization
     // Write CSV file for easy import into graphing tools
-    std::ofstream reportFile("benchmark_results.csv");
+    std::ofstream reportFile("benchmark_results.csv", appendReport ? std::ios::app : std::ios::trunc);
     if (reportFile.is_open()) {
-        reportFile << "Database,Operation,Time(s),Operations,Ops/s\n";
+        if (!appendReport) {
+            reportFile << "Database,Operation,Time(s),Operations,Ops/s,P50(ms),P99(ms),MB/s,Config\n";
+        }
 
         for (const auto& test : tests) {
             const auto& results = test->results;
@@ -1109,23 +5934,91 @@ void runBenchmarks() {
 
             // Insert
             reportFile << dbName << ",Insert," << results.insertTime << ","
-                       << results.insertOps << "," << (results.insertTime > 0 ? results.insertOps / results.insertTime : 0) << "\n";
+                       << results.insertOps << "," << (results.insertTime > 0 ? results.insertOps / results.insertTime : 0) << ",,,"
+                       << (results.insertTime > 0 ? results.insertBytes / (1024.0 * 1024.0) / results.insertTime : 0) << "," << configLabel << "\n";
 
             // Query
             reportFile << dbName << ",Query," << results.queryTime << ","
-                       << results.queryOps << "," << (results.queryTime > 0 ? results.queryOps / results.queryTime : 0) << "\n";
+                       << results.queryOps << "," << (results.queryTime > 0 ? results.queryOps / results.queryTime : 0) << ",,,"
+                       << (results.queryTime > 0 ? results.queryBytes / (1024.0 * 1024.0) / results.queryTime : 0) << "," << configLabel << "\n";
 
             // Update
             reportFile << dbName << ",Update," << results.updateTime << ","
-                       << results.updateOps << "," << (results.updateTime > 0 ? results.updateOps / results.updateTime : 0) << "\n";
+                       << results.updateOps << "," << (results.updateTime > 0 ? results.updateOps / results.updateTime : 0) << ",,,"
+                       << (results.updateTime > 0 ? results.updateBytes / (1024.0 * 1024.0) / results.updateTime : 0) << "," << configLabel << "\n";
 
             // Delete
             reportFile << dbName << ",Delete," << results.deleteTime << ","
-                       << results.deleteOps << "," << (results.deleteTime > 0 ? results.deleteOps / results.deleteTime : 0) << "\n";
+                       << results.deleteOps << "," << (results.deleteTime > 0 ? results.deleteOps / results.deleteTime : 0) << ",,,," << configLabel << "\n";
 
             // Parallel
             reportFile << dbName << ",Parallel," << results.parallelTime << ","
-                       << results.parallelOps << "," << (results.parallelTime > 0 ? results.parallelOps / results.parallelTime : 0) << "\n";
+                       << results.parallelOps << "," << (results.parallelTime > 0 ? results.parallelOps / results.parallelTime : 0) << ",,,"
+                       << (results.parallelTime > 0 ? results.parallelBytes / (1024.0 * 1024.0) / results.parallelTime : 0) << "," << configLabel << "\n";
+
+            // Footprint, in bytes in the Operations column
+            reportFile << dbName << ",Footprint(bytes),," << results.footprintBytes << ",,,,," << configLabel << "\n";
+            reportFile << dbName << ",RSS growth(bytes),," << results.rssBytes << ",,,,," << configLabel << "\n";
+            reportFile << dbName << ",Peak RSS growth(bytes),," << results.peakRssBytes << ",,,,," << configLabel << "\n";
+
+            // Extra phases
+            for (const auto& result : test->phaseResults) {
+                reportFile << dbName << "," << result.operation << "," << result.time << ","
+                           << result.ops << "," << (result.time > 0 ? result.ops / result.time : 0) << ",";
+                if (result.hasLatency) {
+                    reportFile << result.p50Ms << "," << result.p99Ms;
+                } else {
+                    reportFile << ",";
+                }
+                reportFile << ",";
+                if (result.bytes > 0 && result.time > 0) {
+                    reportFile << result.bytes / (1024.0 * 1024.0) / result.time;
+                }
+                reportFile << "," << configLabel << "\n";
+            }
+
+            // Page faults and RSS per phase, counts in the Operations column
+            for (const auto& sample : test->resourceUsage) {
+                reportFile << dbName << ",MinorFaults " << sample.phase << ",," << sample.minorFaults << ",,,,," << configLabel << "\n";
+                reportFile << dbName << ",MajorFaults " << sample.phase << ",," << sample.majorFaults << ",,,,," << configLabel << "\n";
+                reportFile << dbName << ",RSS(bytes) " << sample.phase << ",," << sample.rssBytes << ",,,,," << configLabel << "\n";
+            }
+
+            // I/O per phase and file type: call counts with P50/P99, byte totals in the Operations column
+            for (const auto& sample : test->ioUsage) {
+                auto calls = [&](const std::string& name, uint64_t count, const LatencyHistogram& latency) {
+                    reportFile << dbName << ",IO " << name << " " << sample.phase << ",," << count << ",,"
+                               << latency.percentileMs(50) << "," << latency.percentileMs(99) << ",," << configLabel << "\n";
+                };
+                auto bytes = [&](const std::string& name, uint64_t count) {
+                    reportFile << dbName << ",IO " << name << " " << sample.phase << ",," << count << ",,,,," << configLabel << "\n";
+                };
+                for (int type = 0; type < IO_FILE_TYPES; type++) {
+                    const IoTypeStats& stats = sample.files[type];
+                    if (stats.reads + stats.writes + stats.syncs == 0) continue;
+                    std::string file = IO_FILE_TYPE_NAMES[type];
+                    calls(file + " reads", stats.reads, stats.readLatency);
+                    bytes(file + " read bytes", stats.readBytes);
+                    calls(file + " writes", stats.writes, stats.writeLatency);
+                    bytes(file + " write bytes", stats.writeBytes);
+                    calls(file + " syncs", stats.syncs, stats.syncLatency);
+                }
+                bytes("process reads", sample.process.readCalls);
+                bytes("process read bytes", sample.process.readBytes);
+                bytes("process writes", sample.process.writeCalls);
+                bytes("process write bytes", sample.process.writeBytes);
+            }
+
+            // Allocations per phase, totals in the Operations column; divide by "Alloc ops" for per-op figures
+            for (const auto& sample : test->allocUsage) {
+                reportFile << dbName << ",Alloc ops " << sample.phase << ",," << sample.operations << ",,,,," << configLabel << "\n";
+                for (int engine = 0; engine < 2; engine++) {
+                    std::string owner = engine ? "engine " : "harness ";
+                    reportFile << dbName << ",Allocs " << owner << sample.phase << ",," << sample.totals.allocations[engine] << ",,,,," << configLabel << "\n";
+                    reportFile << dbName << ",Alloc bytes " << owner << sample.phase << ",," << sample.totals.bytes[engine] << ",,,,," << configLabel << "\n";
+                }
+                reportFile << dbName << ",Peak heap(bytes) " << sample.phase << ",," << sample.peakHeapBytes << ",,,,," << configLabel << "\n";
+            }
         }
 
         reportFile.close();
@@ -1133,11 +6026,392 @@ void runBenchmarks() {
     }
 }
 
-int main() {
+// Restrict the process to --cores cores and --address-space-mb of address space. Called
+// before any thread starts, so every thread the engines create inherits the core mask
+bool applyProcessLimits() {
+    if (benchmarkOptions.cores > 0) {
+        std::vector<int> allowed = allowedCpus();
+        if (static_cast<int>(allowed.size()) < benchmarkOptions.cores) {
+            std::cerr << "--cores=" << benchmarkOptions.cores << " exceeds the " << allowed.size() << " cores available" << std::endl;
+            return false;
+        }
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (int c = 0; c < benchmarkOptions.cores; c++) {
+            CPU_SET(allowed[c], &mask);
+        }
+        if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+            std::cerr << "Failed to restrict the benchmark to " << benchmarkOptions.cores << " cores" << std::endl;
+            return false;
+        }
+    }
+    if (benchmarkOptions.addressSpaceMb > 0) {
+        struct rlimit limit;
+        limit.rlim_cur = limit.rlim_max = static_cast<rlim_t>(benchmarkOptions.addressSpaceMb) * 1024 * 1024;
+        if (setrlimit(RLIMIT_AS, &limit) != 0) {
+            std::cerr << "Failed to cap address space at " << benchmarkOptions.addressSpaceMb << " MB" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writer child of the crash phase, configured by --crash-writer=ENGINE,SETTING,FD
+bool runCrashWriter(const std::string& spec) {
+    size_t first = spec.find(',');
+    size_t last = spec.rfind(',');
+    if (first == std::string::npos || first == last) {
+        std::cerr << "Invalid --crash-writer value: " << spec << std::endl;
+        return false;
+    }
+    std::string engine = spec.substr(0, first);
+    std::string setting = spec.substr(first + 1, last - first - 1);
+    int ackFd = std::atoi(spec.c_str() + last + 1);
+
+    std::unique_ptr<BenchmarkTest> test;
+    if (engine == "AnuDB") {
+        test = std::make_unique<AnuDBTest>();
+    } else if (engine == "SQLite3") {
+        test = std::make_unique<SQLiteTest>();
+    } else {
+        std::cerr << "Unknown crash writer engine: " << engine << std::endl;
+        return false;
+    }
+    return test->runCrashWriter(setting, ackFd);
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]" << std::endl;
+    std::cout << "  --phase=NAME[,NAME...]     Run extra phases after the core tests:" << std::endl;
+    std::cout << "                               index  insert cost per index count, index build time" << std::endl;
+    std::cout << "                               topk   top-K, OFFSET and keyset pagination latency" << std::endl;
+    std::cout << "                               aggregate  count/sum/avg of price and stock by category" << std::endl;
+    std::cout << "                               scan   full scan, export and streaming JSON-lines import" << std::endl;
+    std::cout << "                               nested indexed queries on nested and sparse fields" << std::endl;
+    std::cout << "                               partial  in-engine $set/$inc/$push/patch vs read-modify-write" << std::endl;
+    std::cout << "                               tombstone  reads after deleting 25/50/90%, before and after compaction" << std::endl;
+    std::cout << "                               timeseries  paced appends with time-window queries and TTL expiry" << std::endl;
+    std::cout << "                               soak   mixed workload for --soak-duration with a per-second timeline" << std::endl;
+    std::cout << "                               interference  reader latency with writers off and at each write rate" << std::endl;
+    std::cout << "                               checkpoint  single-document write latency and WAL growth" << std::endl;
+    std::cout << "                               coldstart  reopen time and first reads after page cache eviction" << std::endl;
+    std::cout << "                               crash  recovery time and surviving writes after SIGKILL mid-write" << std::endl;
+    std::cout << "                               builder  json vs flat document building, and insert throughput" << std::endl;
+    std::cout << "                               encoding  JSON text vs CBOR/MessagePack/BSON/UBJSON storage (SQLite)" << std::endl;
+    std::cout << "  --index-build-docs=N       Documents loaded before timing index builds (default "
+              << NUM_INDEX_BUILD_DOCUMENTS << ")" << std::endl;
+    std::cout << "  --scan-threads=N           Also run a partitioned scan with N threads in the scan phase" << std::endl;
+    std::cout << "  --ts-duration=S            Seconds the time-series phase appends for (default 30)" << std::endl;
+    std::cout << "  --ts-rate=N                Time-series appends per second, 0 for unthrottled (default 1000)" << std::endl;
+    std::cout << "  --ts-retention=S           Seconds a reading is kept before the expiry thread deletes it (default 10)" << std::endl;
+    std::cout << "  --ts-window=S              Seconds covered by each time-window query (default 5)" << std::endl;
+    std::cout << "  --soak-duration=S          Seconds the soak phase runs (default 3600)" << std::endl;
+    std::cout << "  --soak-stall-pct=P         Seconds below P% of the median ops/s count as stalls (default 25)" << std::endl;
+    std::cout << "  --soak-format=F            Soak timeline format: csv or json (default csv)" << std::endl;
+    std::cout << "  --rw-write-rates=N[,N...]  Total writes/s per interference step, 0 for readers alone (default 0,100,1000,5000)" << std::endl;
+    std::cout << "  --rw-readers=N             Reader threads in the interference phase (default 2)" << std::endl;
+    std::cout << "  --rw-writers=N             Writer threads in the interference phase (default 2)" << std::endl;
+    std::cout << "  --key-format=F[,F...]      Document id format: legacy, seq, random, uuid4, uuid7, composite" << std::endl;
+    std::cout << "  --doc-size=S[,S...]        Document size class: default, small, medium, large, xlarge, mixed" << std::endl;
+    std::cout << "  --doc-nesting=N            Nesting depth of each items[] entry (overrides the size class)" << std::endl;
+    std::cout << "  --doc-array-length=N       Entries in the items[] array (overrides the size class)" << std::endl;
+    std::cout << "  --doc-fields=N             String fields in the attributes object (overrides the size class)" << std::endl;
+    std::cout << "  --sqlite-schema=S[,S...]   SQLite layout: shadow, generated, expression, jsonb, without-rowid" << std::endl;
+    std::cout << "  --sqlite-checkpoint=C[,C...]  SQLite WAL checkpoints: default, auto-N, passive, restart, truncate, idle" << std::endl;
+    std::cout << "  --sqlite-bind=B[,B...]     SQLite document binds and reads: transient (copied) or static (zero-copy)" << std::endl;
+    std::cout << "  --encodings=E[,E...]       Encodings for the encoding phase: json, cbor, msgpack, bson, ubjson (default all)" << std::endl;
+    std::cout << "  --cache-mb=N[,N...]        Cache budget per engine in MB (SQLite cache_size), default engine defaults" << std::endl;
+    std::cout << "  --mmap=M[,M...]            Memory-mapped reads: off or on (SQLite mmap_size)" << std::endl;
+    std::cout << "  --io-stats=on|off          Count I/O per phase and file type (SQLite VFS, process totals)" << std::endl;
+    std::cout << "  --storage-profile=P[,P...] Emulated storage for SQLite: none, sd, emmc, usb" << std::endl;
+    std::cout << "  --cores=K                  Run the whole benchmark on the first K allowed cores" << std::endl;
+    std::cout << "  --pin-threads=on|off       Pin each parallel-phase worker to one core" << std::endl;
+    std::cout << "  --address-space-mb=N       Cap the process address space (RLIMIT_AS) at N MB" << std::endl;
+    std::cout << "  --alloc-stats=on|off       Count heap allocations per phase, harness and engine apart" << std::endl;
+    std::cout << "  --help                     Show this message" << std::endl;
+    std::cout << "Options marked [,...] accept a comma-separated list; the whole benchmark" << std::endl;
+    std::cout << "then runs once per value (once per combination when several are given)." << std::endl;
+}
+
+// Options that accept a list of values and run the benchmark once per value
+const std::vector<std::string> SWEEP_OPTIONS = {"--key-format", "--doc-size", "--sqlite-schema", "--sqlite-checkpoint",
+                                              "--sqlite-bind", "--cache-mb", "--mmap", "--storage-profile"};
+
+// A sweep option and the values it takes, in command-line order
+struct SweepDimension {
+    std::string name;
+    std::vector<std::string> values;
+};
+
+std::vector<SweepDimension> sweepDimensions;
+
+// Apply a single --name=value option to benchmarkOptions
+bool applyOption(const std::string& name, const std::string& value) {
+    if (name == "--phase") {
+        std::stringstream ss(value);
+        std::string phase;
+        while (std::getline(ss, phase, ',')) {
+            if (std::find(EXTRA_PHASES.begin(), EXTRA_PHASES.end(), phase) == EXTRA_PHASES.end()) {
+                std::cerr << "Unknown phase: " << phase << std::endl;
+                return false;
+            }
+            benchmarkOptions.phases.push_back(phase);
+        }
+    } else if (name == "--index-build-docs") {
+        benchmarkOptions.indexBuildDocuments = std::atoi(value.c_str());
+        if (benchmarkOptions.indexBuildDocuments <= 0) {
+            std::cerr << "Invalid --index-build-docs value: " << value << std::endl;
+            return false;
+        }
+    } else if (name == "--scan-threads") {
+        benchmarkOptions.scanThreads = std::atoi(value.c_str());
+        if (benchmarkOptions.scanThreads <= 0) {
+            std::cerr << "Invalid --scan-threads value: " << value << std::endl;
+            return false;
+        }
+    } else if (name == "--ts-duration" || name == "--ts-rate" || name == "--ts-retention" || name == "--ts-window") {
+        int seconds = std::atoi(value.c_str());
+        bool allowZero = name == "--ts-rate";
+        if (value.empty() || seconds < 0 || (seconds == 0 && !allowZero)) {
+            std::cerr << "Invalid " << name << " value: " << value << std::endl;
+            return false;
+        }
+        int& target = name == "--ts-duration" ? benchmarkOptions.tsDuration
+                    : name == "--ts-rate" ? benchmarkOptions.tsRate
+                    : name == "--ts-retention" ? benchmarkOptions.tsRetention
+                    : benchmarkOptions.tsWindow;
+        target = seconds;
+    } else if (name == "--soak-duration" || name == "--soak-stall-pct") {
+        int count = std::atoi(value.c_str());
+        if (count <= 0 || (name == "--soak-stall-pct" && count > 100)) {
+            std::cerr << "Invalid " << name << " value: " << value << std::endl;
+            return false;
+        }
+        (name == "--soak-duration" ? benchmarkOptions.soakDuration : benchmarkOptions.soakStallPercent) = count;
+    } else if (name == "--soak-format") {
+        if (value != "csv" && value != "json") {
+            std::cerr << "Unknown soak timeline format: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.soakFormat = value;
+    } else if (name == "--rw-write-rates") {
+        benchmarkOptions.rwWriteRates.clear();
+        std::stringstream ss(value);
+        std::string rate;
+        while (std::getline(ss, rate, ',')) {
+            if (rate.empty() || rate.find_first_not_of("0123456789") != std::string::npos) {
+                std::cerr << "Invalid --rw-write-rates value: " << rate << std::endl;
+                return false;
+            }
+            benchmarkOptions.rwWriteRates.push_back(std::atoi(rate.c_str()));
+        }
+    } else if (name == "--rw-readers" || name == "--rw-writers") {
+        int count = std::atoi(value.c_str());
+        if (count <= 0) {
+            std::cerr << "Invalid " << name << " value: " << value << std::endl;
+            return false;
+        }
+        (name == "--rw-readers" ? benchmarkOptions.rwReaders : benchmarkOptions.rwWriters) = count;
+    } else if (name == "--key-format") {
+        if (std::find(KEY_FORMATS.begin(), KEY_FORMATS.end(), value) == KEY_FORMATS.end()) {
+            std::cerr << "Unknown key format: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.keyFormat = value;
+    } else if (name == "--doc-size") {
+        bool known = value == "mixed";
+        for (const auto& shape : DOCUMENT_SHAPES) {
+            known = known || shape.name == value;
+        }
+        if (!known) {
+            std::cerr << "Unknown document size class: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.docSize = value;
+    } else if (name == "--doc-nesting" || name == "--doc-array-length" || name == "--doc-fields") {
+        int count = std::atoi(value.c_str());
+        if (count < 0 || value.empty()) {
+            std::cerr << "Invalid " << name << " value: " << value << std::endl;
+            return false;
+        }
+        int& target = name == "--doc-nesting" ? benchmarkOptions.docNesting
+                    : name == "--doc-array-length" ? benchmarkOptions.docArrayLength
+                    : benchmarkOptions.docFields;
+        target = count;
+    } else if (name == "--mmap") {
+        if (value != "on" && value != "off") {
+            std::cerr << "Invalid --mmap value: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.mmap = value == "on";
+    } else if (name == "--io-stats") {
+        if (value != "on" && value != "off") {
+            std::cerr << "Invalid --io-stats value: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.ioStats = value == "on";
+    } else if (name == "--cores" || name == "--address-space-mb") {
+        int count = std::atoi(value.c_str());
+        if (count <= 0) {
+            std::cerr << "Invalid " << name << " value: " << value << std::endl;
+            return false;
+        }
+        (name == "--cores" ? benchmarkOptions.cores : benchmarkOptions.addressSpaceMb) = count;
+    } else if (name == "--alloc-stats") {
+        if (value != "on" && value != "off") {
+            std::cerr << "Invalid --alloc-stats value: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.allocStats = value == "on";
+    } else if (name == "--pin-threads") {
+        if (value != "on" && value != "off") {
+            std::cerr << "Invalid --pin-threads value: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.pinThreads = value == "on";
+    } else if (name == "--storage-profile") {
+        auto profile = std::find_if(STORAGE_PROFILES.begin(), STORAGE_PROFILES.end(),
+                                    [&](const StorageProfile& candidate) { return candidate.name == value; });
+        if (profile == STORAGE_PROFILES.end()) {
+            std::cerr << "Unknown storage profile: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.storageProfile = profile - STORAGE_PROFILES.begin();
+    } else if (name == "--cache-mb") {
+        benchmarkOptions.cacheMb = std::atoi(value.c_str());
+        if (benchmarkOptions.cacheMb <= 0) {
+            std::cerr << "Invalid --cache-mb value: " << value << std::endl;
+            return false;
+        }
+    } else if (name == "--sqlite-checkpoint") {
+        bool threshold = value.compare(0, 5, "auto-") == 0 && value.size() > 5 &&
+                         value.find_first_not_of("0123456789", 5) == std::string::npos && std::atoi(value.c_str() + 5) > 0;
+        if (!threshold && std::find(SQLITE_CHECKPOINTS.begin(), SQLITE_CHECKPOINTS.end(), value) == SQLITE_CHECKPOINTS.end()) {
+            std::cerr << "Unknown SQLite checkpoint strategy: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.sqliteCheckpoint = value;
+    } else if (name == "--sqlite-schema") {
+        if (std::find(SQLITE_SCHEMAS.begin(), SQLITE_SCHEMAS.end(), value) == SQLITE_SCHEMAS.end()) {
+            std::cerr << "Unknown SQLite schema: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.sqliteSchema = value;
+    } else if (name == "--sqlite-bind") {
+        if (std::find(SQLITE_BIND_MODES.begin(), SQLITE_BIND_MODES.end(), value) == SQLITE_BIND_MODES.end()) {
+            std::cerr << "Unknown SQLite bind mode: " << value << std::endl;
+            return false;
+        }
+        benchmarkOptions.sqliteBind = value;
+    } else if (name == "--encodings") {
+        benchmarkOptions.encodings.clear();
+        std::stringstream ss(value);
+        std::string encoding;
+        while (std::getline(ss, encoding, ',')) {
+            if (std::find(DOCUMENT_ENCODINGS.begin(), DOCUMENT_ENCODINGS.end(), encoding) == DOCUMENT_ENCODINGS.end()) {
+                std::cerr << "Unknown document encoding: " << encoding << std::endl;
+                return false;
+            }
+            benchmarkOptions.encodings.push_back(encoding);
+        }
+        if (benchmarkOptions.encodings.empty()) {
+            std::cerr << "Invalid --encodings value: " << value << std::endl;
+            return false;
+        }
+    } else if (name == "--crash-writer") {
+        // Internal: set by the crash phase when it re-executes this binary as its writer
+        benchmarkOptions.crashWriter = value;
+    } else {
+        std::cerr << "Unknown option: " << name << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Parse --name=value options into benchmarkOptions and sweepDimensions
+bool parseOptions(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (std::find(SWEEP_OPTIONS.begin(), SWEEP_OPTIONS.end(), name) == SWEEP_OPTIONS.end()) {
+            if (!applyOption(name, value)) return false;
+            continue;
+        }
+
+        SweepDimension dimension;
+        dimension.name = name;
+        std::stringstream ss(value);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            // Validate now so a bad value fails before any run starts
+            if (!applyOption(name, item)) return false;
+            dimension.values.push_back(item);
+        }
+        if (dimension.values.empty()) {
+            std::cerr << "Missing value for " << name << std::endl;
+            return false;
+        }
+        sweepDimensions.push_back(dimension);
+    }
+    return true;
+}
+
+// Run the benchmark for every combination of sweep values from dimension onwards
+void runSweep(size_t dimension, const std::string& configLabel, bool& appendReport) {
+    if (dimension == sweepDimensions.size()) {
+        runBenchmarks(configLabel, appendReport);
+        appendReport = true;
+        return;
+    }
+
+    const SweepDimension& sweep = sweepDimensions[dimension];
+    for (const auto& value : sweep.values) {
+        applyOption(sweep.name, value);
+        std::string label = configLabel.empty() ? "" : configLabel + ";";
+        runSweep(dimension + 1, label + sweep.name.substr(2) + "=" + value, appendReport);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        }
+    }
+    if (!parseOptions(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!benchmarkOptions.crashWriter.empty()) {
+        return runCrashWriter(benchmarkOptions.crashWriter) ? 0 : 1;
+    }
+    if (!applyProcessLimits()) {
+        return 1;
+    }
+    if (benchmarkOptions.allocStats && !startAllocationCounting()) {
+        std::cerr << "Failed to install the counting SQLite allocator" << std::endl;
+        return 1;
+    }
+
+    // The VFS is registered once, before any connection opens, if any run uses it
+    bool storageEmulation = benchmarkOptions.storageProfile != 0;
+    for (const auto& sweep : sweepDimensions) {
+        storageEmulation = storageEmulation || sweep.name == "--storage-profile";
+    }
+    if ((benchmarkOptions.ioStats || storageEmulation) && !registerIoAccountingVfs()) {
+        std::cerr << "Failed to register the I/O accounting VFS" << std::endl;
+        return 1;
+    }
+
     std::cout << "AnuDB Load Testing Benchmark" << std::endl;
     std::cout << "=======================================" << std::endl;
 
-    runBenchmarks();
+    bool appendReport = false;
+    runSweep(0, "", appendReport);
 
     return 0;
 }